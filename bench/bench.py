@@ -0,0 +1,99 @@
+"""
+Benchmark harness: generates instances (see generate.py) over a sweep of widths, runs a decomp binary on each of them
+with '--timings' and reports the phases (sage, parse, build, dp), bags/s and the peak memory.
+
+Every run is printed as one JSON object per line (to stdout or '--output'), a readable summary goes to stderr.
+'--compare old.jsonl' prints the dp time of every instance relative to an earlier run of the same sweep.
+
+usage: python3 bench.py --binary ./decomp {--family ktree|grid|pace} {--widths 4 6 8} {--n 200} {--seeds 2}
+                        {--repeat 1} {--threads 1} {--instances file.gr ...} {--output runs.jsonl}
+                        {--compare old.jsonl} {-- <extra decomp arguments>}
+"""
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+import generate
+
+
+def run(binary, gr, td, threads, extra):
+    command = [binary, gr, td, "--threads", str(threads), "--timings"] + extra
+    output = subprocess.run(command, capture_output=True, text=True, check=True).stdout
+    for line in output.splitlines():
+        if line.startswith("timings: "):
+            return json.loads(line[len("timings: "):])
+    raise RuntimeError("no timings in the output of " + " ".join(command))
+
+
+def instances(args, directory):
+    # (name, parameters, .gr, .td) of the sweep
+    for path in args.instances:
+        yield os.path.basename(path), {"family": "file"}, path, os.path.splitext(path)[0] + ".td"
+    if args.instances and args.family is None:
+        return
+    for width in args.widths:
+        for seed in range(args.seeds):
+            if args.family == "grid":
+                if seed > 0:
+                    break
+                instance = generate.grid(max(width, args.n // width), width)
+            elif args.family == "pace":
+                instance = generate.pace(args.n, width, seed)
+            else:
+                instance = generate.partial_ktree(args.n, width, seed)
+            name = "%s_w%d_n%d_s%d" % (args.family or "ktree", width, args.n, seed)
+            prefix = os.path.join(directory, name)
+            generate.write_instance(prefix, *instance)
+            parameters = {"family": args.family or "ktree", "k": width, "n": args.n, "seed": seed}
+            yield name, parameters, prefix + ".gr", prefix + ".td"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--binary", required=True)
+    parser.add_argument("--family", choices=["ktree", "grid", "pace"])
+    parser.add_argument("--widths", type=int, nargs="+", default=[4, 6, 8])
+    parser.add_argument("--n", type=int, default=200)
+    parser.add_argument("--seeds", type=int, default=2)
+    parser.add_argument("--repeat", type=int, default=1)
+    parser.add_argument("--threads", type=int, default=1)
+    parser.add_argument("--instances", nargs="+", default=[])
+    parser.add_argument("--output")
+    parser.add_argument("--compare")
+    parser.add_argument("extra", nargs="*", help="passed on to the binary, after '--'")
+    args = parser.parse_args()
+
+    baseline = {}
+    if args.compare:
+        with open(args.compare, encoding="utf-8") as f:
+            for line in f:
+                record = json.loads(line)
+                baseline[(record["instance"], record["threads"])] = record["dp_s"]
+
+    output = open(args.output, "w", encoding="utf-8") if args.output else sys.stdout
+    print("%-28s %5s %7s %9s %9s %9s %10s %12s %8s" % ("instance", "width", "bags", "parse_s", "build_s", "dp_s",
+          "bags/s", "peak_tables", "vs_old"), file=sys.stderr)
+    with tempfile.TemporaryDirectory() as directory:
+        for name, parameters, gr, td in instances(args, directory):
+            runs = [run(args.binary, gr, td, args.threads, args.extra) for _ in range(args.repeat)]
+            # the median run by dp time represents the instance
+            record = sorted(runs, key=lambda r: r["dp_s"])[len(runs) // 2]
+            record.update(parameters)
+            record.update({"instance": name, "binary": args.binary, "repeat": args.repeat,
+                           "dp_s_min": min(r["dp_s"] for r in runs),
+                           "dp_s_stdev": statistics.stdev(r["dp_s"] for r in runs) if len(runs) > 1 else 0})
+            print(json.dumps(record, sort_keys=True), file=output, flush=True)
+            old = baseline.get((name, record["threads"]))
+            print("%-28s %5d %7d %9.4f %9.4f %9.4f %10.0f %12d %8s" % (name, record["width"], record["bags"],
+                  record["parse_s"], record["build_s"], record["dp_s"], record["bags_per_s"],
+                  record["peak_table_bytes"], "%.2fx" % (record["dp_s"] / old) if old else "-"), file=sys.stderr)
+    if args.output:
+        output.close()
+
+
+if __name__ == "__main__":
+    main()
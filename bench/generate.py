@@ -0,0 +1,119 @@
+"""
+Generators for benchmark instances with a controlled treewidth, written as .gr/.td files (PACE format) that decomp
+reads natively, so no sage is needed:
+  ktree  random partial k-tree, the TD of the construction has width k
+  grid   rows x cols grid, the TD is the path decomposition sweeping the rows (width min(rows, cols))
+  pace   partial k-tree with shuffled vertex labels and a TD from the min-degree heuristic, like PACE instances whose
+         TDs come from a heuristic solver (width >= k, not known in advance)
+
+usage: python3 generate.py ktree <n> <k> <seed> <output_prefix> {<edge_drop_probability>}
+       python3 generate.py grid <rows> <cols> <output_prefix>
+       python3 generate.py pace <n> <k> <seed> <output_prefix> {<edge_drop_probability>}
+"""
+import random
+import sys
+
+
+def partial_ktree(n, k, seed, drop=0.3):
+    # starts with a (k+1)-clique, every further vertex is attached to a k-subset of an existing bag, then edges are
+    # dropped with probability 'drop' (except for a spanning tree, so the graph stays connected)
+    rnd = random.Random(seed)
+    bags = [list(range(1, k + 2))]
+    edges = set((u, v) for u in range(1, k + 2) for v in range(u + 1, k + 2))
+    spanning_tree = set((v - 1, v) for v in range(2, k + 2))
+    td_edges = []
+    for v in range(k + 2, n + 1):
+        parent = rnd.randrange(len(bags))
+        dropped = rnd.choice(bags[parent])
+        clique = [u for u in bags[parent] if u != dropped]
+        edges.update((u, v) for u in clique)
+        spanning_tree.add((clique[0], v))
+        bags.append(clique + [v])
+        td_edges.append((parent + 1, len(bags)))
+    edges = sorted(e for e in edges if e in spanning_tree or rnd.random() >= drop)
+    return n, edges, bags, td_edges
+
+
+def grid(rows, cols):
+    if rows < cols:
+        rows, cols = cols, rows
+    vertex = lambda r, c: r * cols + c + 1
+    n = rows * cols
+    edges = []
+    for r in range(rows):
+        for c in range(cols):
+            if c + 1 < cols:
+                edges.append((vertex(r, c), vertex(r, c + 1)))
+            if r + 1 < rows:
+                edges.append((vertex(r, c), vertex(r + 1, c)))
+    # window of cols+1 consecutive vertices in row-major order, contains every edge
+    bags = [list(range(i, min(n, i + cols) + 1)) for i in range(1, max(1, n - cols) + 1)]
+    td_edges = [(i, i + 1) for i in range(1, len(bags))]
+    return n, sorted(edges), bags, td_edges
+
+
+def min_degree_td(n, edges):
+    # elimination ordering by minimum degree, bag of a vertex is the vertex and its neighbors at elimination time
+    graph = {v: set() for v in range(1, n + 1)}
+    for u, v in edges:
+        graph[u].add(v)
+        graph[v].add(u)
+    order = []
+    bag_of = {}
+    while graph:
+        v = min(graph, key=lambda x: (len(graph[x]), x))
+        order.append(v)
+        bag_of[v] = sorted(graph[v] | {v})
+        for u in graph[v]:
+            graph[u] |= graph[v] - {u}
+            graph[u].discard(v)
+        del graph[v]
+    position = {v: i for i, v in enumerate(order)}
+    bags = [bag_of[v] for v in order]
+    td_edges = []
+    roots = []
+    for i, v in enumerate(order):
+        later = [u for u in bags[i] if u != v]
+        if later:
+            td_edges.append((i + 1, min(position[u] for u in later) + 1))
+        else:
+            roots.append(i + 1)
+    # one TD for all components
+    td_edges.extend(zip(roots, roots[1:]))
+    return bags, td_edges
+
+
+def pace(n, k, seed, drop=0.3):
+    n, edges, _, _ = partial_ktree(n, k, seed, drop)
+    labels = list(range(1, n + 1))
+    random.Random(seed + 1).shuffle(labels)
+    edges = sorted(tuple(sorted((labels[u - 1], labels[v - 1]))) for u, v in edges)
+    bags, td_edges = min_degree_td(n, edges)
+    return n, edges, bags, td_edges
+
+
+def write_instance(prefix, n, edges, bags, td_edges):
+    with open(prefix + ".gr", "w", encoding="utf-8") as f:
+        print("p tw", n, len(edges), file=f)
+        for u, v in edges:
+            print(u, v, file=f)
+    with open(prefix + ".td", "w", encoding="utf-8") as f:
+        print("s td", len(bags), max(len(bag) for bag in bags), n, file=f)
+        for i, bag in enumerate(bags):
+            print("b", i + 1, *bag, file=f)
+        for a, b in td_edges:
+            print(a, b, file=f)
+    return max(len(bag) for bag in bags) - 1
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2 or sys.argv[1] not in ("ktree", "grid", "pace"):
+        raise SystemExit(__doc__)
+    family, args = sys.argv[1], sys.argv[2:]
+    if family == "grid":
+        width = write_instance(args[2], *grid(int(args[0]), int(args[1])))
+    else:
+        generator = partial_ktree if family == "ktree" else pace
+        drop = float(args[4]) if len(args) > 4 else 0.3
+        width = write_instance(args[3], *generator(int(args[0]), int(args[1]), int(args[2]), drop))
+    print("width of the written TD:", width)
@@ -5,707 +5,930 @@
 #include <memory>
 #include <vector>
 #include <cstdint>
-#include <regex>
 #include <optional>
 #include <assert.h>
-#include <cmath>
 #include <numeric>
 #include <functional>
 #include <limits>
 #include <algorithm>
-#include <unordered_set>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <array>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "eliminationOrdering.hpp"
+#include "graphComponents.hpp"
+#include "graphReduction.hpp"
+#include "incrementalDominatingSet.hpp"
+#include "minDominatingSet.hpp"
+#include "niceTdCache.hpp"
 
-/************************************************************************************************************************/
-/* Definition of Data-Structured used in the algorithm */
-enum class BagType : char
-{
-    Forget = 'f', Intro = 'i', Join = 'j', Leaf = 'l'
-};
-
-enum class Color : std::uint8_t
-{
-    // a white vertex means, that in the current sub-problem it is not added to the dominating set
-    // -> must be dominated in the partial solution
-    White = 0,
-    // a black vertex means, that in the current sub-problem it is added to the dominating set
-    // -> must dominate all white vertices of the partial solution 
-    Black = 1,
-    // a grey vertex means, that this vertex is not part of the current solution
-    // -> does not have to be dominated in the partial solution, but might be
-    Grey = 2
-};
-constexpr Color colorArr[] = { Color::White, Color::Black, Color::Grey }; // use for easy iteration
-constexpr std::tuple<Color, Color, Color> consistentColorsArr[] = {
-    std::make_tuple(Color::Black, Color::Black, Color::Black),
-    std::make_tuple(Color::White, Color::White, Color::Grey),
-    std::make_tuple(Color::White, Color::Grey, Color::White),
-    std::make_tuple(Color::Grey, Color::Grey, Color::Grey)
-};
+/**
+ * Reads the nice-TD of a .gr file into 'niceBags' (ordered by bag number, the root is bag 0).
+ * 'readNiceTD' builds it natively (with the preprocessing of makeOptimizedNiceTreeDecomposition unless disabled) from
+ * a given .td file, or without one from the heuristic TD of eliminationOrdering.hpp, which improves it for 'tdSeconds'
+ * or, if not given, for a budget by its estimated DP cost (and warns if the width stays far above the lower bound).
+ * With a 'reduction' the rules of graphReduction.hpp shrink the graph first, the nice-TD is then the one of the kernel
+ * that is stored in 'reduction' (no bags for an empty kernel). With 'components' the graph is split into its connected
+ * components instead, each with the nice-TD of its part of the TD (none for trivial components, see
+ * trivialDominatingSet). 'readNiceTDWithSage' calls a python script that uses sage to compute an optimal TD first and writes
+ * the nice-TD into 'ntdFile' (binary format of niceTdCache.hpp), which is then mapped into 'mappedBags'.
+ * Both print errors and return false on failure.
+ */
+struct Timings;
+struct ComponentTDs;
+bool readNiceTD(const std::string&, const std::optional<std::string>&, bool, std::optional<double>, ReducedGraph*, ComponentTDs*,
+    std::vector<NiceBag>&, Timings&);
+bool readNiceTDWithSage(const std::vector<std::string>&, const std::string&, std::optional<MappedNiceTD>&, Timings&);
 
-struct ColorPairHash
-{
-    std::size_t operator()(const std::shared_ptr<const std::pair<int, Color>>& key) const noexcept
-    {
-        return std::hash<int>{}(key.get()->first) ^ std::hash<Color>{}(key.get()->second);
-    }
-};
+/**
+ * Batch mode: solves all .gr/.td pairs of a directory (every .gr file with a .td file of the same name) or of a
+ * manifest (one '<gr_file> <td_file>' pair per line, '#' starts a comment) in one process. Instances are handed out to
+ * 'threadCount' workers as they become free, each instance runs the DP single-threaded. Every instance writes one
+ * result line to 'outputFile' (JSONL, or CSV if the name ends in '.csv') as soon as it is done. Returns the exit code.
+ */
+struct BatchOptions;
+int runBatch(const std::string&, const std::string&, std::size_t, const BatchOptions&);
 
-struct ColorPairEquality
-{
-    using is_transparent = void;  // Enable heterogeneous lookup
+/**
+ * '--edits': solves the nice-TD once with an IncrementalDominatingSet, then applies the edit batches of 'editsFile' one
+ * after the other and prints the new size and the number of recomputed bags of each. A line '+ u v' adds the edge uv,
+ * '- u v' removes it, an empty line ends a batch ('#' starts a comment). Returns the exit code.
+ */
+int runEdits(const std::vector<NiceBag>&, const std::string&, std::size_t, EngineChoice);
 
-    bool operator()(
-        const std::shared_ptr<const std::pair<int, Color>>& p1,
-        const std::shared_ptr<const std::pair<int, Color>>& p2
-    ) const {
-        return p1.get()->first == p2.get()->first && p1.get()->second == p2.get()->second;
-    }
-    bool operator()(
-        const std::pair<int, Color>& p1,
-        const std::shared_ptr<const std::pair<int, Color>>& p2
-    ) const {
-        return p1.first == p2.get()->first && p1.second == p2.get()->second;
-    }
-    bool operator()(
-        const std::shared_ptr<const std::pair<int, Color>>& p1,
-        const std::pair<int, Color>& p2
-    ) const {
-        return p1.get()->first == p2.first && p1.get()->second == p2.second;
-    }
-};
+/**
+ * '--weights': reads the vertex weights of 'weightsFile' into 'weights' (indexed by vertex id, up to the largest vertex
+ * of 'niceBags'), one 'v w' line per vertex ('#' starts a comment), vertices without a line weigh 1.
+ * Prints errors and returns false on failure.
+ */
+bool readWeights(const std::string&, const std::vector<NiceBag>&, std::vector<std::uint32_t>&);
 
-// this data-structure will keep track of a pair: (vertex -> color) via shared_ptrs
-// to avoid creating the same pair multiple times
-std::unordered_set<
-    std::shared_ptr<const std::pair<int, Color>>,
-    ColorPairHash,
-    ColorPairEquality
-> colorPairSet = {};
+/**
+ * '--profile': prints the bags, table entries, bytes and seconds per bag type as one JSON object and writes the
+ * phases and all bags of 'profile' as a Chrome trace (chrome://tracing or ui.perfetto.dev) to 'traceFile', one row
+ * per worker. Returns false if the file could not be written.
+ */
+bool writeProfile(const std::string&, const DPProfile&);
 
-std::shared_ptr<const std::pair<int, Color>> lookup(int vertex, Color color)
+/**
+ * Wall-clock seconds of the phases of a run, printed as one JSON object with '--timings' (see bench/bench.py).
+ * 'build' is the construction of the nice-TD from a parsed TD, 'dp' includes allocating and filling the tables.
+ */
+struct Timings
 {
-    const auto ptr = std::make_shared<std::pair<int, Color>>(vertex, color);
-    const auto it = colorPairSet.find(ptr);
-    if (it == colorPairSet.end())
+    using Clock = std::chrono::steady_clock;
+
+    double sage = 0;
+    double parse = 0;
+    // the reduction rules with '--reduce'
+    double reduce = 0;
+    // the heuristic TD for inputs without a .td file
+    double td = 0;
+    double build = 0;
+    double dp = 0;
+    // with '--profile' the phases are recorded in it as well
+    DPProfile* profile = nullptr;
+
+    // length of the phase 'name' that started at 'start'
+    double phase(const std::string& name, Clock::time_point start) const
     {
-        colorPairSet.insert(ptr);
-        return std::move(ptr);
+        return profile != nullptr ? profile->addPhase(name, start) : secondsSince(start);
     }
-    else
+
+    static double secondsSince(Clock::time_point start)
     {
-        return *it;
+        return std::chrono::duration<double>(Clock::now() - start).count();
     }
-}
-
-// one function mapping a set of vertices to 3 colors 
-using Coloring = std::vector<std::shared_ptr<const std::pair<int, Color>>>;
+};
 
-struct ColoringHash 
+// '--components': the connected components of the graph (or of the kernel) and their nice-TDs
+struct ComponentTDs
 {
-    std::size_t operator()(const Coloring& key) const noexcept
-    {
-        std::size_t hash = 0;
-        
-        for (const auto ptr : key)
-        {
-            const auto& [vertex, color] = *ptr.get(); 
-            // commutative accumulation of hash, such that order of coloring-pairs does not influence the hash
-            hash += std::hash<int>{}(vertex) ^ std::hash<Color>{}(color);
-        }
+    std::vector<GraphComponent> components;
+    std::vector<std::vector<NiceBag>> niceTDs;
+};
 
-        return hash;
-    }
+// options of a single run that also apply to every instance of a batch
+struct BatchOptions
+{
+    bool preprocess;
+    WitnessOptions witness;
+    EngineChoice engines;
+    bool prune;
+    std::string spillDirectory;
 };
 
-struct ColoringEquality
+/**
+ * Main function reads a .gr file (and an optional .td file) into a nice-tree-decomposition,
+ * then starts min-dominating-set calculation
+ */
+int main(int argc, char** argv)
 {
-    bool operator()(
-        const Coloring& key1,
-        const Coloring& key2
-    )
-        const noexcept
+    // positional arguments are the .gr file and an optional .td file, options may appear anywhere
+    std::vector<std::string> inputFiles;
+    std::size_t threadCount = 1;
+    std::optional<std::string> cacheFile;
+    WitnessOptions witness;
+    bool printTimings = false;
+    bool preprocess = true;
+    bool prune = false;
+    EngineChoice engines = EngineChoice::Auto;
+    bool validEngine = true;
+    std::string spillDirectory;
+    std::optional<std::string> profileFile;
+    std::optional<std::string> editsFile;
+    std::optional<std::string> weightsFile;
+    std::optional<double> tdSeconds;
+    bool exactTd = false;
+    bool reduce = false;
+    bool splitComponents = false;
+    std::optional<std::string> batch;
+    std::string batchOutput = "results.jsonl";
+    for (auto i = 1; i < argc; ++i)
     {
-        if (key1.size() != key2.size())
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
         {
-            return false;
+            threadCount = std::strtoul(argv[++i], nullptr, 10);
         }
-        else
+        else if (arg == "--engine" && i + 1 < argc)
         {
-            for (const auto &pair1 : key1)
-            {
-                bool contains = false;
-                for (const auto &pair2 : key2)
-                {
-                    if (pair1 == pair2)
-                    {
-                        contains = true;
-                        break;
-                    }
-                }
-                if (!contains)
-                {
-                    return false;
-                }
-            }
-            return true;
+            const std::string engine = argv[++i];
+            validEngine = engine == "auto" || engine == "dense" || engine == "sparse";
+            engines = engine == "dense" ? EngineChoice::Dense : engine == "sparse" ? EngineChoice::Sparse : EngineChoice::Auto;
         }
-    }
-};
-
-struct Bag
-{
-    std::uint16_t number;
-    BagType type;
-    std::optional<std::uint16_t> parentNumber;
-    std::vector<int> bagElements;
-    std::vector<std::pair<int, int>> introduceEdges;
-    std::optional<std::uint16_t> child1 = std::nullopt;
-    std::optional<std::uint16_t> child2 = std::nullopt;
-
-    // datastructure to map colorings (minimum compatible set) to values
-    using HashMap = std::unordered_map<
-        Coloring,           // key
-        int,                // value
-        ColoringHash,       // key-hashing-function (commutative)
-        ColoringEquality    // key-equality (commutative)
-    >;
-    HashMap c;
-
-    // used only for join nodes
-    using ConsistentColorings = std::vector<std::tuple<Coloring, Coloring, Coloring>>;
-    ConsistentColorings consistentColorings;
-
-    explicit Bag(std::uint16_t number, BagType type, std::optional<std::uint16_t> parentNumber,
-        std::vector<int> vertices, std::vector<std::pair<int, int>> edges) :
-        number(number), type(type), parentNumber(parentNumber), bagElements(std::move(vertices)),
-        introduceEdges(std::move(edges))
-    {
-        // only the root (reserved number 0) has not parent in a labelled TD
-        assert(number == 0 || parentNumber.has_value());
-        // root must be empty bag
-        assert(number != 0 || bagElements.size() == 0);
-        // introduce edges not possible on leaf-nodes
-        assert(introduceEdges.size() == 0 || type != BagType::Leaf);
-
-        // fill search state for this bag
-        const auto bagsize = bagElements.size();
-        if (bagsize > 0)
+        else if (arg == "--prune")
         {
-            HashMap map;
-            map.reserve(std::pow(3, bagsize));
-
-            // builds all 3^bagsize states with backtracking
-            std::function<void(Coloring&)> backtrack1 = [&backtrack1, &bagsize, &map, this](Coloring& current) -> void
-            {
-                if (current.size() == bagsize)
-                {
-                    map[current] = std::numeric_limits<int>::max();
-                    return;
-                }
-                for (const auto &color : colorArr)
-                {
-                    const auto coloredVertex = bagElements[current.size()];
-                    current.push_back(lookup(coloredVertex, color));
-                    backtrack1(current);
-                    current.pop_back();
-                }
-            };
-            Coloring current;
-            current.reserve(bagsize);
-            backtrack1(current);
-            this->c = std::move(map);
-
-            // if this node is a join node compute all consistent colorings
-            if (type == BagType::Join)
-            {
-                ConsistentColorings ccs;
-                ccs.reserve(std::pow(4, bagsize));
-
-                // builds all 4^bagsize consistent states with backtracking
-                std::function<void(Coloring&, Coloring&, Coloring&)> backtrack2 = [&backtrack2, &ccs, &bagsize, this]
-                    (Coloring& current1, Coloring& current2, Coloring& current3) -> void
-                {
-                    if (current1.size() == bagsize)
-                    {
-                        ccs.emplace_back(current1, current2, current3);
-                        return;
-                    }
-
-                    for (const auto [c1,c2,c3] : consistentColorsArr)
-                    {
-                        const auto vertex = bagElements[current1.size()];
-                        current1.push_back(lookup(vertex, c1));
-                        current2.push_back(lookup(vertex, c2));
-                        current3.push_back(lookup(vertex, c3));
-                        backtrack2(current1, current2, current3);
-                        current1.pop_back();
-                        current2.pop_back();
-                        current3.pop_back();
-                    }
-                };
-                Coloring current1;
-                Coloring current2;
-                Coloring current3;
-                current1.reserve(bagElements.size());
-                current2.reserve(bagElements.size());
-                current3.reserve(bagElements.size());
-                backtrack2(current1, current2, current3);
-                this->consistentColorings = std::move(ccs);
-            }
+            prune = true;
+        }
+        else if (arg == "--edits" && i + 1 < argc)
+        {
+            editsFile = argv[++i];
+        }
+        else if (arg == "--weights" && i + 1 < argc)
+        {
+            weightsFile = argv[++i];
+        }
+        else if (arg == "--profile" && i + 1 < argc)
+        {
+            profileFile = argv[++i];
+        }
+        else if (arg == "--spill-dir" && i + 1 < argc)
+        {
+            spillDirectory = argv[++i];
+        }
+        else if (arg == "--td-seconds" && i + 1 < argc)
+        {
+            tdSeconds = std::strtod(argv[++i], nullptr);
+        }
+        else if (arg == "--exact-td")
+        {
+            exactTd = true;
+        }
+        else if (arg == "--reduce")
+        {
+            reduce = true;
+        }
+        else if (arg == "--components")
+        {
+            splitComponents = true;
+        }
+        else if (arg == "--no-td-preprocessing")
+        {
+            preprocess = false;
+        }
+        else if (arg == "--timings")
+        {
+            printTimings = true;
+        }
+        else if (arg == "--witness")
+        {
+            witness.enabled = true;
+        }
+        else if (arg == "--witness-checkpoint" && i + 1 < argc)
+        {
+            witness.enabled = true;
+            witness.checkpointInterval = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--batch" && i + 1 < argc)
+        {
+            batch = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            batchOutput = argv[++i];
+        }
+        else if (arg == "--td-cache" && i + 1 < argc)
+        {
+            cacheFile = argv[++i];
+        }
+        else
+        {
+            inputFiles.push_back(arg);
         }
     }
-
-    bool operator==(const Bag& otherBag) const
+    // read.py picks the binary format by the extension
+    const auto validCache = !cacheFile.has_value() || std::filesystem::path(cacheFile.value()).extension() == ".ntd";
+    // the reduction needs the parsed graph and changes the problem of the kernel, it is only done for a single run
+    // and so is the split into components, which solves several nice-TDs
+    const auto validReduce = !(reduce || splitComponents) || (!batch.has_value() && !cacheFile.has_value() && !exactTd &&
+        !weightsFile.has_value() && !editsFile.has_value() && !(splitComponents && profileFile.has_value()));
+    const auto validInputs = batch.has_value() ? inputFiles.empty() && !cacheFile.has_value() && !weightsFile.has_value() :
+        inputFiles.size() >= 1 && inputFiles.size() <= 2 && !(weightsFile.has_value() && editsFile.has_value());
+    const auto validSpill = spillDirectory.empty() || std::filesystem::is_directory(spillDirectory);
+    if (!validInputs || threadCount == 0 || !validCache || !validEngine || !validSpill || !validReduce)
     {
-        return number == otherBag.number;
+        std::cerr << "Usage: " << argv[0] << " <path_to_gr_file> {<path_to_td_file>} {--threads <N>} {--td-cache <path_to_ntd_file>}"
+            " {--witness} {--witness-checkpoint <K>} {--timings} {--td-seconds <S> | --exact-td} {--reduce} {--components}"
+            " {--no-td-preprocessing} {--engine auto|dense|sparse} {--prune} {--spill-dir <directory>}"
+            " {--profile <trace.json>} {--edits <edits_file> | --weights <weights_file>}\n"
+            "       " << argv[0] << " --batch <directory_or_manifest> {--output <results.jsonl|results.csv>} {--threads <N>}"
+            " {--witness} {--no-td-preprocessing} {--engine auto|dense|sparse} {--prune} {--spill-dir <directory>}\n";
+        return 1;
+    }
+    if (batch.has_value())
+    {
+        return runBatch(batch.value(), batchOutput, threadCount, { preprocess, witness, engines, prune, spillDirectory });
     }
 
-    std::string toString() const
+    // an existing cache is mapped if it belongs to the graph, otherwise it is written once the nice TD is built
+    // with a given TD the nice TD is built natively, without one from a heuristic TD unless an optimal one is requested
+    // from sage
+    std::vector<NiceBag> niceBags;
+    std::optional<MappedNiceTD> mappedBags;
+    ReducedGraph reduction;
+    ComponentTDs components;
+    Timings timings;
+    DPProfile profile;
+    timings.profile = profileFile.has_value() ? &profile : nullptr;
+    const auto hasTd = inputFiles.size() == 2 && std::filesystem::path(inputFiles[1]).extension() == ".td";
+    if (cacheFile.has_value() && std::filesystem::exists(cacheFile.value()))
     {
-        std::string ret = std::string("") + static_cast<char>(type) + std::string("-Bag ");
-        if (parentNumber.has_value())
+        try
         {
-            ret += std::to_string(number) + std::string(" with parent: ")
-            + std::to_string(parentNumber.value()) + std::string(" and vertices: ");
+            const auto start = Timings::Clock::now();
+            mappedBags.emplace(cacheFile.value(), fingerprintOf(readGraph(inputFiles[0])));
+            timings.parse = timings.phase("parse", start);
         }
-        else
+        catch (const std::exception& e)
         {
-            ret += std::string("(Root) ") + std::to_string(number);
-            return ret;
+            std::cerr << e.what() << std::endl;
+            return 1;
         }
-        for (auto i = 0; i < bagElements.size(); ++i)
+    }
+    else if (hasTd || (inputFiles.size() == 1 && !exactTd))
+    {
+        const auto tdFile = hasTd ? std::make_optional(inputFiles[1]) : std::nullopt;
+        if (!readNiceTD(inputFiles[0], tdFile, preprocess, tdSeconds, reduce ? &reduction : nullptr,
+            splitComponents ? &components : nullptr, niceBags, timings))
         {
-            ret += std::to_string(bagElements[i]);
-            if (i + 1 < bagElements.size())
-            {
-                ret += std::string(", ");
-            }
+            return 1;
         }
-        if (introduceEdges.size() > 0)
+        if (cacheFile.has_value())
         {
-            ret += "; Introduced edges: [";
-            for (auto i = 0; i < introduceEdges.size(); ++i)
+            try
             {
-                ret += std::string("(") + std::to_string(introduceEdges[i].first) + std::string(",") + std::to_string(introduceEdges[i].second) + std::string(")");
-                if (i + 1 < introduceEdges.size())
-                {
-                    ret += std::string(", ");
-                }
+                writeNiceTDCache(cacheFile.value(), niceBags, fingerprintOf(readGraph(inputFiles[0])));
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << e.what() << std::endl;
             }
-            ret += "]";
         }
-        return ret;
     }
-
-    std::string toStringState() const
+    else
     {
-        std::string ret = std::string("");
-        if (c.size() > 0)
+        // without a cache the script writes into a temp file that is unique per process, so several instances can
+        // run in the same directory
+        const auto ntdFile = cacheFile.value_or((std::filesystem::temp_directory_path() /
+            ("_decomp_" + std::to_string(getpid()) + ".ntd")).string());
+        const auto success = readNiceTDWithSage(inputFiles, ntdFile, mappedBags, timings);
+        if (!cacheFile.has_value() && std::filesystem::exists(ntdFile) && !std::filesystem::remove(ntdFile))
         {
-            auto index = 0;
-            for (const auto& [coloring, value] : c)
-            {
-                ret += std::string("Coloring NR.") + std::to_string(index) + std::string("(c=") + std::to_string(value) + std::string("):\n");
-                for (const auto ptr : coloring)
-                {
-                    const auto& [vertex, color] = *ptr.get();
-                    ret += std::string("\tNode ") + std::to_string(vertex) + std::string(" -> ") + std::to_string(static_cast<uint8_t>(color)) + std::string("\n");
-                }
-                index++;
-            }
+            std::cerr << "File: " << ntdFile << " couldn't be deleted" << std::endl;
+        }
+        if (!success)
+        {
+            return 1;
         }
-
-        return ret;
     }
-};
-/************************************************************************************************************************/
 
-/* Declaring Functions used for the different Bag-Types during traversal */
-void introduceVertexNode(Bag * const, const Bag * const);
-void joinNode(Bag * const, const Bag * const, const Bag * const);
-void forgetNode(Bag * const, const Bag * const);
-/**
- * Additionally to the common bag-types 'introduceEdge' is necessary as a way to 
- * introduce an edge between two vertices in the original graph.
- * This function is used to update the current bag-state for when we get the information, 
- * that a vertex of the bag might not longer be required to be dominated.
- * (By switching the value of the White/Black or Black/White colorings with the value of a
- *  grey coloring instead of the white one) 
- */
-void introduceEdge(Bag * const, const Bag * const, const std::pair<int, int>&);
-
-/**
- * Main function reads a .gr file by calling a python script that uses sage to handle
- * the construction of a nice-tree-decomposition, then starts min-dominating-set calculation
- */
-int main(int argc, char** argv)
-{
-    // this block calls the python script 
-    if (argc < 2 || argc > 3)
+    /**************************/
+    /* LOGIC-PART begins here */
+    /**************************/
+    // the edits and the weights work on a copy of a mapped nice-TD, the DP reads it from the mapping
+    if (mappedBags.has_value() && (editsFile.has_value() || weightsFile.has_value()))
     {
-        std::cerr << "Usage: " << argv[0] << " <path_to_gr_file> {<path_to_td_file>}\n";
-        return 1;
+        niceBags = mappedBags->niceBags();
+        mappedBags.reset();
     }
-    const auto tempFilename = "_decomp_.temp";
-    std::ofstream out{tempFilename};
-    if (!out) {
-        std::cerr << "Could not create " << tempFilename << '\n';
-        return 1;
-    }
-    out.close();
-    std::string command = "python3 read.py ";
-    command += argv[1];
-    command += " ";
-    if (argc == 3)
+    if (editsFile.has_value())
     {
-        command += argv[2];
-        command += " ";
+        return runEdits(niceBags, editsFile.value(), threadCount, engines);
     }
-    command += tempFilename;
-    int ret = std::system(command.c_str());
-
-    // the python script writes the nice TD into a file which is now parsed into the Bag datastructure
-    std::ifstream in(tempFilename);
-    if (!in)
+    std::vector<std::uint32_t> weights;
+    if (weightsFile.has_value() && !readWeights(weightsFile.value(), niceBags, weights))
     {
-        std::cerr << "Could not open " << tempFilename << std::endl;
         return 1;
     }
-    std::vector<std::unique_ptr<Bag>> bags;
-    auto root = std::make_unique<Bag>(
-        0, BagType::Forget, std::nullopt, std::vector<int>{}, std::vector<std::pair<int, int>>{}
-    );
-    bags.push_back(std::move(root));
-    std::string line;
-    std::regex pattern1(R"(\((\d+)\,\{([^}]*)\})"); // matches the bag number and everything inside curly brackets accept closed curly bracket
-    std::regex pattern2(R"(\[\((\d+))"); // matches the bag number of the parent bag
-    std::regex pattern3(R"(\((\d+)\,(\d+)\))"); // matches an edge
-    std::smatch match;
-    std::getline(in, line); // first line is root node, which we already have
-    while (std::getline(in, line))
+    const auto start = Timings::Clock::now();
+    DominatingSetResult result{};
+    try
     {
-        std::istringstream strstr(line);
-        std::string word;
-
-        // first word in line is the bag number and list of vertices inside the bag
-        strstr >> word;
-        std::uint16_t currentBagNumber;
-        std::vector<int> currentVertices;
-        if (std::regex_search(word, match, pattern1))
-        {
-            currentBagNumber = std::stoi(match[1].str());
-            std::stringstream strstrTemp(match[2].str());
-            std::string currentVertex;
-            while (std::getline(strstrTemp, currentVertex, ','))
-            {
-                currentVertices.push_back(std::stoi(currentVertex));
-            }
+        if (splitComponents)
+        {
+            const auto sums = solveComponents(components.components, components.niceTDs, threadCount, witness, engines,
+                prune, spillDirectory);
+            result = sums.result;
+            std::cout << "Solved " << components.components.size() << " components: " << sums.trivial << " trivial, "
+                << sums.alone << " alone with all threads, " << sums.concurrent << " concurrently in " << sums.batches
+                << " batches." << std::endl;
         }
-        else
+        else if (mappedBags.has_value())
         {
-            std::cerr << "Error while trying to match word: " << word << std::endl;
+            result = minDominatingSet(mappedBags.value(), threadCount, witness, engines, prune, nullptr, spillDirectory,
+                timings.profile);
         }
-        
-        // second word in line is type of bag
-        strstr >> word;
-        BagType currentBagType = static_cast<BagType>(word[0]);
-
-        // third word in line contains parent node
-        strstr >> word;
-        std::uint16_t currentParentBag;
-        if (std::regex_search(word, match, pattern2))
+        // the rules may leave an empty kernel, its dominating set is empty
+        else if (!niceBags.empty())
         {
-            currentParentBag = std::stoi(match[1].str());
+            result = minDominatingSet(niceBags, threadCount, witness, engines, prune, nullptr, spillDirectory,
+                timings.profile, weights, reduction.dominated);
         }
-        else
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    timings.dp = timings.phase("dp", start);
+    if (reduce)
+    {
+        // the taken vertices are added back, the witness is mapped to the original vertices
+        result.size += static_cast<int>(reduction.forced.size());
+        if (witness.enabled)
         {
-            std::cerr << "Error while trying to match word: " << word << std::endl;
+            result.dominatingSet = originalDominatingSet(reduction, result.dominatingSet);
         }
+    }
 
-        // fourth word in line contains possible introduce edges 
-        std::vector<std::pair<int, int>> introduceEdges;
-        strstr >> word;
-        if (word.size() > 2)
-        {
-            // strip brackets
-            word = word.substr(1, word.size() - 2);
-            auto wordIt = std::cbegin(word); 
-            while (std::regex_search(wordIt, std::cend(word), match, pattern3))
-            {
-                introduceEdges.emplace_back(std::stoi(match[1].str()), std::stoi(match[2].str()));
-                wordIt = match.suffix().first;
-            }
+    const std::string problem = weights.empty() ? "minimum-dominating-set" : "minimum-weight-dominating-set";
+    std::cout << "The " << (weights.empty() ? "size" : "weight") << " of the " << problem << " in this graph is: "
+        << result.size << "." << std::endl;
+    if (witness.enabled)
+    {
+        std::cout << "A " << problem << ":";
+        for (const auto vertex : result.dominatingSet)
+        {
+            std::cout << " " << vertex;
         }
-
-        // but the bag in the bags
-        auto bag = std::make_unique<Bag>(
-            currentBagNumber, currentBagType,
-            std::make_optional(currentParentBag),
-            std::move(currentVertices),
-            std::move(introduceEdges)
-        );
-        bags.push_back(std::move(bag));
-    }
-    if (!in.eof())
-    {
-        std::cerr << "Error while reading " << tempFilename << std::endl;
-        return 1;
+        std::cout << std::endl;
     }
-    in.close();
-    // remove the temp file which we read python output from
-    if (!std::filesystem::remove(tempFilename)) {
-        std::cerr << "File: " << tempFilename << "not found or couldn't be deleted" << std::endl;
+    std::cout << "Peak memory of live DP-tables: " << result.peakTableBytes << " bytes (" << result.valueBytes
+        << "-byte values)." << std::endl;
+    std::cout << "Table engines: " << result.engineBags[static_cast<std::size_t>(Engine::Dense)] << " dense bags, "
+        << result.engineBags[static_cast<std::size_t>(Engine::Sparse)] << " sparse bags." << std::endl;
+    if (prune)
+    {
+        std::cout << "Greedy upper bound: " << result.upperBound << ", pruned states: " << result.prunedStates << "."
+            << std::endl;
     }
-
-
-    /**************************/
-    /* LOGIC-PART begins here */
-    /**************************/
-    // set children in all bags, then compute postorder traversal
-    for (const auto &bag : bags)
+    if (!spillDirectory.empty())
     {
-        if (bag.get()->parentNumber.has_value())
+        std::cout << "Spilled tables of pending join branches: " << result.spilledBytes << " bytes." << std::endl;
+    }
+    if (printTimings)
+    {
+        std::size_t width = 0;
+        std::size_t bagCount = 0;
+        const auto count = [&width, &bagCount](const auto& bags)
         {
-            const auto parentNumber = bag.get()->parentNumber.value();
-            if (!bags[parentNumber].get()->child1.has_value())
-            {
-                bags[parentNumber].get()->child1 = std::make_optional(bag.get()->number);
-            }
-            else
+            bagCount += bags.size();
+            for (std::size_t number = 0; number < bags.size(); ++number)
             {
-                bags[parentNumber].get()->child2 = std::make_optional(bag.get()->number);
+                width = std::max(width, bags[number].vertices.size());
             }
+        };
+        count(niceBags);
+        if (mappedBags.has_value())
+        {
+            count(mappedBags.value());
+        }
+        for (const auto &componentBags : components.niceTDs)
+        {
+            count(componentBags);
         }
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        // ru_maxrss is in kilobytes on linux
+        std::cout << "timings: {\"sage_s\": " << timings.sage << ", \"parse_s\": " << timings.parse
+            << ", \"reduce_s\": " << timings.reduce << ", \"td_s\": " << timings.td
+            << ", \"build_s\": " << timings.build << ", \"dp_s\": " << timings.dp
+            << ", \"bags\": " << bagCount << ", \"width\": " << (width == 0 ? 0 : width - 1)
+            << ", \"bags_per_s\": " << (timings.dp > 0 ? bagCount / timings.dp : 0)
+            << ", \"threads\": " << threadCount << ", \"size\": " << result.size
+            << ", \"peak_table_bytes\": " << result.peakTableBytes << ", \"value_bytes\": " << result.valueBytes
+            << ", \"spilled_bytes\": " << result.spilledBytes
+            << ", \"max_rss_bytes\": " << static_cast<std::size_t>(usage.ru_maxrss) * 1024 << "}" << std::endl;
     }
-    std::vector<std::uint16_t> postorder;
-    postorder.reserve(bags.size());
-    std::function<void(uint16_t)> postorderTraversal = [&postorder, &bags, &postorderTraversal](uint16_t number) -> void
+    if (profileFile.has_value() && !writeProfile(profileFile.value(), profile))
     {
-        const auto bag = bags[number].get();
+        return 1;
+    }
+    return 0;
+}
 
-        if (bag->child1.has_value())
+bool readNiceTD(const std::string& grFile, const std::optional<std::string>& tdFile, bool preprocess,
+    std::optional<double> tdSeconds,
+    ReducedGraph* reduction, ComponentTDs* components, std::vector<NiceBag>& niceBags, Timings& timings)
+{
+    try
+    {
+        auto start = Timings::Clock::now();
+        auto graph = readGraph(grFile);
+        auto td = tdFile.has_value() ? readTreeDecomposition(tdFile.value()) : TreeDecomposition{};
+        timings.parse = timings.phase("parse", start);
+        if (tdFile.has_value() && (reduction != nullptr || components != nullptr))
         {
-            postorderTraversal(bag->child1.value());
+            // the given TD has to be one of the original graph, its restriction to a subgraph is a TD of it
+            detail::rootTreeDecomposition(graph, td, 1);
         }
-        if (bag->child2.has_value())
+        if (reduction != nullptr)
         {
-            postorderTraversal(bag->child2.value());
+            start = Timings::Clock::now();
+            *reduction = reduceGraph(graph);
+            timings.reduce = timings.phase("reduce", start);
+            const auto dominated = std::count(reduction->dominated.cbegin(), reduction->dominated.cend(), true);
+            std::cout << "Reduced the graph of " << graph.vertexCount << " vertices and " << graph.edges.size()
+                << " edges to a kernel of " << reduction->graph.vertexCount << " vertices (" << dominated
+                << " of them dominated) and " << reduction->graph.edges.size() << " edges, "
+                << reduction->forced.size() << " vertices are in the solution, in " << timings.reduce << " s." << std::endl;
+            if (tdFile.has_value() && reduction->graph.vertexCount > 0)
+            {
+                td = restrictTreeDecomposition(td, reduction->original);
+            }
+            graph = reduction->graph;
+            if (graph.vertexCount == 0)
+            {
+                niceBags.clear();
+                return true;
+            }
         }
-
-        postorder.push_back(bag->number);
-    };
-    postorderTraversal(0);
-
-    // iterate bags in correct order and call appropriate bag-logic functions 
-    for (auto &&number : postorder)
-    {
-        const auto bag = bags[number].get();
-
-        if (!bag->parentNumber.has_value())
+        if (components != nullptr)
         {
-            // found root, finished postorder-traversal now print the min cost of the only child
-            const auto child = bags[bag->child1.value()].get();
-            assert(child->bagElements.size() == 1); // property of nice TD
-            auto minDominatingSetSize = std::numeric_limits<int>::max();
-            for (const auto &pair : child->c)
+            // the time of the improvement phase is shared by the components by their number of vertices
+            components->components = connectedComponents(graph, reduction != nullptr ? reduction->dominated : std::vector<bool>{});
+            std::size_t trivial = 0;
+            std::size_t width = 0;
+            std::size_t farAbove = 0;
+            for (const auto &component : components->components)
             {
-                if (minDominatingSetSize > pair.second)
+                auto &componentBags = components->niceTDs.emplace_back();
+                if (trivialDominatingSet(component).has_value())
                 {
-                    minDominatingSetSize = pair.second;
+                    ++trivial;
+                    continue;
                 }
+                start = Timings::Clock::now();
+                TreeDecomposition componentTD;
+                if (tdFile.has_value())
+                {
+                    componentTD = restrictTreeDecomposition(td, component.original);
+                }
+                else
+                {
+                    auto heuristic = heuristicTreeDecomposition(component.graph, tdSeconds.has_value() ?
+                        std::make_optional(tdSeconds.value() * component.graph.vertexCount / graph.vertexCount) : std::nullopt);
+                    farAbove += farAboveLowerBound(heuristic);
+                    componentTD = std::move(heuristic.td);
+                }
+                timings.td += Timings::secondsSince(start);
+                start = Timings::Clock::now();
+                componentBags = preprocess ? makeOptimizedNiceTreeDecomposition(component.graph, componentTD) :
+                    makeNiceTreeDecomposition(component.graph, componentTD);
+                timings.build += Timings::secondsSince(start);
+                for (const auto &bag : componentBags)
+                {
+                    width = std::max(width, bag.vertices.size());
+                }
+            }
+            std::cout << "Split the graph into " << components->components.size() << " connected components (" << trivial
+                << " of them trivial), the widest nice-TD has width " << (width == 0 ? 0 : width - 1) << "." << std::endl;
+            if (farAbove > 0)
+            {
+                std::cerr << "Warning: the heuristic TDs of " << farAbove << " components are far wider than their lower"
+                    " bounds, a larger --td-seconds may make the DP much faster." << std::endl;
             }
-            std::cout << "The size of the minimum-dominating-set in this graph is: " << minDominatingSetSize << "." << std::endl;
+            return true;
         }
-        else if (bag->type == BagType::Intro)
+        if (!tdFile.has_value())
         {
-            introduceVertexNode(bag, bags[bag->child1.value()].get());
+            start = Timings::Clock::now();
+            auto heuristic = heuristicTreeDecomposition(graph, tdSeconds);
+            timings.td = timings.phase("td", start);
+            td = std::move(heuristic.td);
+            std::cout << "Heuristic TD of width " << heuristic.width << " (lower bound " << heuristic.lowerBound
+                << (heuristic.width == heuristic.lowerBound ? ", optimal" : "") << ") from " << heuristic.orderings
+                << " elimination orderings in " << timings.td << " s." << std::endl;
+            if (farAboveLowerBound(heuristic))
+            {
+                std::cerr << "Warning: the heuristic TD is far wider than the lower bound, a larger --td-seconds or"
+                    " --exact-td (sage) may make the DP much faster." << std::endl;
+            }
         }
-        else if (bag->type == BagType::Forget)
+        start = Timings::Clock::now();
+        niceBags = preprocess ? makeOptimizedNiceTreeDecomposition(graph, td) : makeNiceTreeDecomposition(graph, td);
+        timings.build = timings.phase("build", start);
+        if (preprocess)
         {
-            forgetNode(bag, bags[bag->child1.value()].get());
+            std::cout << "Estimated DP cost of the nice-TD: " << estimatedCost(makeNiceTreeDecomposition(graph, td))
+                << " before preprocessing, " << estimatedCost(niceBags) << " after." << std::endl;
         }
-        else if (bag->type == BagType::Join)
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool readNiceTDWithSage(const std::vector<std::string>& inputFiles, const std::string& ntdFile,
+    std::optional<MappedNiceTD>& mappedBags, Timings& timings)
+{
+    // this block calls the python script, which writes the nice TD in the binary cache format for output files
+    // ending in '.ntd'
+    std::string command = "python3 read.py ";
+    command += inputFiles[0];
+    command += " ";
+    if (inputFiles.size() == 2)
+    {
+        command += inputFiles[1];
+        command += " ";
+    }
+    command += ntdFile;
+    auto start = Timings::Clock::now();
+    if (std::system(command.c_str()) != 0)
+    {
+        std::cerr << "read.py failed for " << inputFiles[0] << std::endl;
+        return false;
+    }
+    // the script computes the TD and builds the nice TD, both are counted as sage
+    timings.sage = timings.phase("sage", start);
+
+    try
+    {
+        start = Timings::Clock::now();
+        mappedBags.emplace(ntdFile, fingerprintOf(readGraph(inputFiles[0])));
+        timings.parse = timings.phase("parse", start);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace
+{
+
+// quotes a string for JSON, paths are the only strings written
+std::string jsonString(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (const auto c : text)
+    {
+        if (c == '"' || c == '\\')
         {
-            joinNode(bag, bags[bag->child1.value()].get(), bags[bag->child2.value()].get());
+            quoted += '\\';
         }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
 
-        // introduce edges
-        for (const auto &edge : bag->introduceEdges)
+std::vector<std::pair<std::string, std::string>> batchInstances(const std::string& batch)
+{
+    std::vector<std::pair<std::string, std::string>> instances;
+    if (std::filesystem::is_directory(batch))
+    {
+        for (const auto &entry : std::filesystem::directory_iterator(batch))
         {
-            introduceEdge(bag, bags[bag->child1.value()].get(), edge);
+            if (entry.path().extension() == ".gr")
+            {
+                auto td = entry.path();
+                instances.emplace_back(entry.path().string(), td.replace_extension(".td").string());
+            }
         }
+        std::sort(instances.begin(), instances.end());
+        return instances;
     }
-
-    /* prints all parsed bags with a lot more info
-    for (auto &&i : bags)
+    std::ifstream manifest(batch);
+    if (!manifest)
     {
-        std::cout << i.get()->toString() << std::endl;
-        std::cout << "Child1: " << i.get()->child1.value_or(-1) << ", Child2: " << i.get()->child2.value_or(-1) << std::endl;
-        std::cout << i.get()->toStringState() << std::endl;
-    }*/
-    return 0;
+        throw std::runtime_error("Could not open batch manifest " + batch);
+    }
+    std::string line;
+    while (std::getline(manifest, line))
+    {
+        std::istringstream fields(line.substr(0, line.find('#')));
+        std::string gr, td;
+        if (fields >> gr)
+        {
+            fields >> td;
+            instances.emplace_back(gr, td);
+        }
+    }
+    return instances;
 }
 
-void introduceEdge(Bag * const bag, const Bag * const child, const std::pair<int, int>& uv)
+} // namespace
+
+int runBatch(const std::string& batch, const std::string& outputFile, std::size_t threadCount, const BatchOptions& options)
 {
-    const auto uBlack = lookup(uv.first, Color::Black);
-    const auto vWhite = lookup(uv.second, Color::White);
-    const auto uWhite = lookup(uv.first, Color::White);
-    const auto vBlack = lookup(uv.second, Color::Black);
+    std::vector<std::pair<std::string, std::string>> instances;
+    try
+    {
+        instances = batchInstances(batch);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::ofstream out(outputFile, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Could not write " << outputFile << std::endl;
+        return 1;
+    }
+    const auto csv = std::filesystem::path(outputFile).extension() == ".csv";
+    if (csv)
+    {
+        out << "instance,size,width,bags,time_s,dp_s,peak_table_bytes,error" << std::endl;
+    }
 
-    for (auto &[coloring, value] : bag->c)
+    std::mutex outputMutex;
+    std::size_t solved = 0;
+    indexed::parallelFor(instances.size(), threadCount, [&](std::size_t i)
     {
-        if (std::find(coloring.cbegin(), coloring.cend(), uBlack) != coloring.end() &&
-            std::find(coloring.cbegin(), coloring.cend(), vWhite) != coloring.end())
+        const auto &[grFile, tdFile] = instances[i];
+        const auto start = Timings::Clock::now();
+        std::string error;
+        DominatingSetResult result{};
+        std::size_t width = 0;
+        std::size_t bagCount = 0;
+        double dp = 0;
+        try
         {
-            Coloring vGreyCopy;
-            vGreyCopy.reserve(coloring.size());
-            for (const auto ptr : coloring)
+            if (tdFile.empty() || !std::filesystem::exists(tdFile))
             {
-                if (ptr == vWhite)
-                {
-                    vGreyCopy.push_back(lookup(uv.second, Color::Grey));
-                }
-                else
-                {
-                    vGreyCopy.push_back(ptr);
-                }
+                throw std::runtime_error("no .td file for " + grFile);
+            }
+            const auto graph = readGraph(grFile);
+            const auto td = readTreeDecomposition(tdFile);
+            const auto niceBags = options.preprocess ? makeOptimizedNiceTreeDecomposition(graph, td) :
+                makeNiceTreeDecomposition(graph, td);
+            bagCount = niceBags.size();
+            for (const auto &bag : niceBags)
+            {
+                width = std::max(width, bag.vertices.size());
             }
-            value = bag->c.at(vGreyCopy);
+            width = width == 0 ? 0 : width - 1;
+            // every worker keeps its table buffers for its next instances
+            thread_local indexed::TableMemory tables;
+            const auto dpStart = Timings::Clock::now();
+            result = minDominatingSet(niceBags, 1, options.witness, options.engines, options.prune, &tables,
+                options.spillDirectory);
+            dp = Timings::secondsSince(dpStart);
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+        const auto time = Timings::secondsSince(start);
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        solved += error.empty();
+        if (csv)
+        {
+            // errors are free text, commas would shift the columns
+            std::replace(error.begin(), error.end(), ',', ';');
+            out << grFile << "," << (error.empty() ? std::to_string(result.size) : "") << "," << width << ","
+                << bagCount << "," << time << "," << dp << "," << result.peakTableBytes << "," << error << std::endl;
+            return;
         }
-        else if (
-            std::find(coloring.cbegin(), coloring.cend(), uWhite) != coloring.end() &&
-            std::find(coloring.cbegin(), coloring.cend(), vBlack) != coloring.end())
+        out << "{\"instance\": " << jsonString(grFile);
+        if (error.empty())
         {
-            Coloring uGreyCopy;
-            uGreyCopy.reserve(coloring.size());
-            for (const auto ptr : coloring)
+            out << ", \"size\": " << result.size << ", \"width\": " << width << ", \"bags\": " << bagCount
+                << ", \"time_s\": " << time << ", \"dp_s\": " << dp << ", \"peak_table_bytes\": " << result.peakTableBytes;
+            if (options.witness.enabled)
             {
-                if (ptr == uWhite)
+                out << ", \"dominating_set\": [";
+                for (std::size_t v = 0; v < result.dominatingSet.size(); ++v)
                 {
-                    uGreyCopy.push_back(lookup(uv.first, Color::Grey));
-                }
-                else
-                {
-                    uGreyCopy.push_back(ptr);
+                    out << (v == 0 ? "" : ", ") << result.dominatingSet[v];
                 }
+                out << "]";
             }
-            value = bag->c.at(uGreyCopy); 
         }
-    }
+        else
+        {
+            out << ", \"error\": " << jsonString(error);
+        }
+        out << "}" << std::endl;
+    });
+    std::cout << "Solved " << solved << " of " << instances.size() << " instances, results in " << outputFile << "."
+        << std::endl;
+    return solved == instances.size() ? 0 : 1;
 }
 
-void joinNode(Bag * const bag, const Bag * const child1, const Bag * const child2)
+int runEdits(const std::vector<NiceBag>& niceBags, const std::string& editsFile, std::size_t threadCount,
+    EngineChoice engines)
 {
-    assert(bag->consistentColorings.size() > 0);
-    
-    for (const auto &consistentTriple : bag->consistentColorings)
+    std::ifstream edits(editsFile);
+    if (!edits)
+    {
+        std::cerr << "Could not open edits file " << editsFile << std::endl;
+        return 1;
+    }
+    auto start = Timings::Clock::now();
+    IncrementalDominatingSet solver(niceBags, threadCount, engines);
+    std::cout << "The size of the minimum-dominating-set in this graph is: " << solver.size() << "." << std::endl;
+    std::cout << "Tables of all " << niceBags.size() << " bags: " << solver.tableBytes() << " bytes, solved in "
+        << Timings::secondsSince(start) << " s." << std::endl;
+
+    std::vector<std::pair<int, int>> added;
+    std::vector<std::pair<int, int>> removed;
+    std::size_t batch = 0;
+    const auto solveBatch = [&]() -> bool
     {
-        const auto &coloring = std::get<0>(consistentTriple); 
-        auto compatibleSetSize = 0;
-        for (const auto ptr : coloring)
+        if (added.empty() && removed.empty())
         {
-            if ((*ptr.get()).second == Color::Black)
+            return true;
+        }
+        ++batch;
+        try
+        {
+            start = Timings::Clock::now();
+            const auto recomputed = solver.update(added, removed);
+            std::cout << "After edit batch " << batch << " (" << added.size() << " added, " << removed.size()
+                << " removed edges): " << solver.size() << ", recomputed " << recomputed << " of " << niceBags.size()
+                << " bags in " << Timings::secondsSince(start) << " s." << std::endl;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Edit batch " << batch << ": " << e.what() << std::endl;
+            return false;
+        }
+        added.clear();
+        removed.clear();
+        return true;
+    };
+    std::string line;
+    while (std::getline(edits, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            if (!solveBatch())
             {
-                compatibleSetSize++;
+                return 1;
             }
+            continue;
         }
-        auto consistentColoring1Value = child1->c.at(std::get<1>(consistentTriple));
-        auto consistentColoring2Value = child2->c.at(std::get<2>(consistentTriple));
-        
-        // we need to compute 'c1+c2-compatibleSize', we treat max() as infinity so overflow checks work a bit differently
-        auto res = 0;
-        if (consistentColoring1Value == std::numeric_limits<int>::max() ||
-            consistentColoring2Value == std::numeric_limits<int>::max())
+        std::istringstream fields(line.substr(0, line.find('#')));
+        std::string sign;
+        int u = 0;
+        int v = 0;
+        if (!(fields >> sign))
         {
-            res = std::numeric_limits<int>::max();
+            continue;
         }
-        else
+        if ((sign != "+" && sign != "-") || !(fields >> u >> v))
         {
-            res = consistentColoring1Value + consistentColoring2Value - compatibleSetSize;
+            std::cerr << "Invalid edit: " << line << std::endl;
+            return 1;
         }
-
-        // adopt min of all consistent colorings
-        bag->c.at(coloring) = std::min(bag->c.at(coloring), res);
+        (sign == "+" ? added : removed).emplace_back(u, v);
     }
+    return solveBatch() ? 0 : 1;
 }
 
-void forgetNode(Bag * const bag, const Bag * const child)
+bool readWeights(const std::string& weightsFile, const std::vector<NiceBag>& niceBags, std::vector<std::uint32_t>& weights)
 {
-    const auto w = std::accumulate(child->bagElements.cbegin(), child->bagElements.cend(), 0) -
-        std::accumulate(bag->bagElements.cbegin(), bag->bagElements.cend(), 0);
-
-    for (auto &[coloring, value] : bag->c)
+    std::ifstream in(weightsFile);
+    if (!in)
     {
-        auto blackCopy = coloring;
-        blackCopy.push_back(lookup(w, Color::Black));
-        auto whiteCopy = coloring;
-        whiteCopy.push_back(lookup(w, Color::White));
-
-        value = std::min(child->c.at(blackCopy), child->c.at(whiteCopy));
+        std::cerr << "Could not open weights file " << weightsFile << std::endl;
+        return false;
     }
-}
-
-void introduceVertexNode(Bag * const bag, const Bag * const child)
-{
-    const auto v = std::accumulate(bag->bagElements.cbegin(), bag->bagElements.cend(), 0) -
-        std::accumulate(child->bagElements.cbegin(), child->bagElements.cend(), 0);
-
-    for (auto &[coloring, value] : bag->c)
+    int largestVertex = 0;
+    for (const auto &bag : niceBags)
     {
-        if (child->type == BagType::Leaf)
+        for (const auto vertex : bag.vertices)
         {
-            assert(coloring.size() == 1);
-            const auto& pair = *(coloring.front().get());
-            if (pair.second == Color::White)
-            {
-                value = std::numeric_limits<int>::max();
-            }
-            else if (pair.second == Color::Grey)
-            {
-                value = 0;
-            }
-            else
-            {
-                assert(pair.second == Color::Black);
-                value = 1;
-            }
-            continue;
+            largestVertex = std::max(largestVertex, vertex);
         }
-
-        if (std::find(coloring.cbegin(), coloring.cend(), lookup(v, Color::White)) != coloring.end())
+    }
+    weights.assign(static_cast<std::size_t>(largestVertex) + 1, 1);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line.substr(0, line.find('#')));
+        long long vertex = 0;
+        long long weight = 0;
+        if (!(fields >> vertex))
         {
-            value = std::numeric_limits<int>::max();
             continue;
         }
-        else
+        if (!(fields >> weight) || vertex < 0 || weight < 0 || weight > std::numeric_limits<std::uint32_t>::max())
         {
-            Coloring copyWithoutNewVertex;
-            copyWithoutNewVertex.reserve(coloring.size() - 1);
-            Color newVertexColor;
-
-            for (const auto ptr : coloring)
-            {
-                const auto& [vertex, color] = *ptr.get();
-                if (vertex != v)
-                {
-                    copyWithoutNewVertex.push_back(ptr);
-                }
-                else
-                {
-                    newVertexColor = color;
-                }
-            }
+            std::cerr << "Invalid weight: " << line << std::endl;
+            return false;
+        }
+        // vertices that are in no bag are not part of the graph
+        if (vertex <= largestVertex)
+        {
+            weights[static_cast<std::size_t>(vertex)] = static_cast<std::uint32_t>(weight);
+        }
+    }
+    return true;
+}
 
-            auto childValue = child->c.at(copyWithoutNewVertex); 
-            if (newVertexColor == Color::Grey || childValue == std::numeric_limits<int>::max())
-            {
-                value = childValue;
-            }
-            else
-            {
-                value = 1 + childValue;
-            }
+bool writeProfile(const std::string& traceFile, const DPProfile& profile)
+{
+    // the root forgets the last vertex, it is listed on its own
+    const auto typeName = [](const DPProfile::BagEvent& bag) -> std::string
+    {
+        if (bag.number == 0)
+        {
+            return "root";
+        }
+        switch (bag.type)
+        {
+        case BagType::Leaf: return "leaf";
+        case BagType::Intro: return "intro";
+        case BagType::Forget: return "forget";
+        default: return "join";
         }
+    };
+    struct TypeTotals
+    {
+        std::size_t bags = 0;
+        std::size_t states = 0;
+        std::size_t bytes = 0;
+        double seconds = 0;
+    };
+    const std::array<std::string, 5> typeNames{ "leaf", "intro", "forget", "join", "root" };
+    std::array<TypeTotals, 5> totals{};
+    for (const auto &bag : profile.bags)
+    {
+        auto &total = totals[std::find(typeNames.cbegin(), typeNames.cend(), typeName(bag)) - typeNames.cbegin()];
+        total.bags++;
+        total.states += bag.states;
+        total.bytes += bag.bytes;
+        total.seconds += bag.seconds;
+    }
+    std::ostringstream summary;
+    summary << "{";
+    for (std::size_t type = 0; type < typeNames.size(); ++type)
+    {
+        summary << (type == 0 ? "" : ", ") << jsonString(typeNames[type]) << ": {\"bags\": " << totals[type].bags
+            << ", \"states\": " << totals[type].states << ", \"bytes\": " << totals[type].bytes
+            << ", \"seconds\": " << totals[type].seconds << "}";
+    }
+    summary << "}";
+    std::cout << "profile: " << summary.str() << std::endl;
+
+    // complete events ('X') in microseconds, the phases in process 0 and the bags in process 1 with a thread per worker
+    std::ofstream out(traceFile);
+    out << "{\"displayTimeUnit\": \"ms\", \"summary\": " << summary.str() << ", \"traceEvents\": [\n"
+        << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"phases\"}},\n"
+        << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"bags\"}}";
+    for (const auto &phase : profile.phases)
+    {
+        out << ",\n{\"name\": " << jsonString(phase.name) << ", \"cat\": \"phase\", \"ph\": \"X\", \"ts\": "
+            << phase.start * 1e6 << ", \"dur\": " << phase.seconds * 1e6 << ", \"pid\": 0, \"tid\": 0}";
+    }
+    for (const auto &bag : profile.bags)
+    {
+        out << ",\n{\"name\": " << jsonString(typeName(bag)) << ", \"cat\": \"bag\", \"ph\": \"X\", \"ts\": "
+            << bag.start * 1e6 << ", \"dur\": " << bag.seconds * 1e6 << ", \"pid\": 1, \"tid\": " << bag.worker
+            << ", \"args\": {\"bag\": " << bag.number << ", \"size\": " << bag.bagSize << ", \"engine\": "
+            << (bag.engine == Engine::Dense ? "\"dense\"" : "\"sparse\"") << ", \"states\": " << bag.states
+            << ", \"bytes\": " << bag.bytes << "}}";
+    }
+    out << "\n]}" << std::endl;
+    if (!out)
+    {
+        std::cerr << "Could not write the profile to " << traceFile << std::endl;
+        return false;
     }
+    return true;
 }
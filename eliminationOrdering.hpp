@@ -0,0 +1,401 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "treeDecomposition.hpp"
+
+/**
+ * Native TDs for graphs without a .td file, instead of sage's exact treewidth (which does not finish on larger graphs):
+ * greedy elimination orderings (min-degree and min-fill-in), the TD of an ordering, the minor-min-width lower bound on
+ * the treewidth and a time-bounded improvement phase that reruns min-fill-in with random tie-breaking.
+ */
+
+enum class EliminationHeuristic
+{
+    MinDegree, MinFill
+};
+
+struct HeuristicTreeDecomposition
+{
+    TreeDecomposition td;
+    std::size_t width = 0;
+    // no TD of the graph is narrower, the width is optimal if both are equal
+    std::size_t lowerBound = 0;
+    // estimated DP cost of the TD, see qualityOf
+    double estimatedCost = 0;
+    // orderings that were tried, the two greedy ones and the randomized ones of the improvement phase
+    std::size_t orderings = 0;
+};
+
+namespace detail
+{
+
+/**
+ * The graph while its vertices are eliminated: eliminating a vertex turns its remaining neighbors into a clique. Keeps
+ * the sorted adjacency of the remaining vertices and, for min-fill-in, the number of missing edges among the
+ * neighbors of every vertex. The fill is updated per added edge ab instead of recomputed: the common neighbors of a
+ * and b lose a missing edge, a gains one for every neighbor that is not adjacent to b (and vice versa). Removing the
+ * eliminated vertex then only depends on the degrees, its neighbors are a clique.
+ */
+class EliminationGraph
+{
+public:
+    explicit EliminationGraph(const Graph& graph, bool trackFill) :
+        adjacency(graph.adjacency), fill(trackFill ? adjacency.size() : 0, 0)
+    {
+        for (auto &neighbors : adjacency)
+        {
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        }
+        for (std::size_t vertex = 0; vertex < fill.size(); ++vertex)
+        {
+            const auto &neighbors = adjacency[vertex];
+            for (auto a = neighbors.cbegin(); a != neighbors.cend(); ++a)
+            {
+                for (auto b = std::next(a); b != neighbors.cend(); ++b)
+                {
+                    fill[vertex] += !adjacent(*a, *b);
+                }
+            }
+        }
+    }
+
+    const std::vector<int>& neighborsOf(int vertex) const
+    {
+        return adjacency[vertex];
+    }
+
+    std::size_t fillOf(int vertex) const
+    {
+        return fill[vertex];
+    }
+
+    // removes 'vertex' and makes its neighbors a clique, returns the vertices whose degree or fill changed
+    std::vector<int> eliminate(int vertex)
+    {
+        const auto neighbors = std::move(adjacency[vertex]);
+        adjacency[vertex].clear();
+        std::vector<int> changed(neighbors);
+        std::vector<int> common;
+        for (auto a = neighbors.cbegin(); a != neighbors.cend(); ++a)
+        {
+            for (auto b = std::next(a); b != neighbors.cend(); ++b)
+            {
+                auto &aNeighbors = adjacency[*a];
+                auto &bNeighbors = adjacency[*b];
+                const auto at = std::lower_bound(aNeighbors.begin(), aNeighbors.end(), *b);
+                if (at != aNeighbors.end() && *at == *b)
+                {
+                    continue;
+                }
+                if (!fill.empty())
+                {
+                    common.clear();
+                    std::set_intersection(aNeighbors.cbegin(), aNeighbors.cend(), bNeighbors.cbegin(),
+                        bNeighbors.cend(), std::back_inserter(common));
+                    for (const auto other : common)
+                    {
+                        --fill[other];
+                        changed.push_back(other);
+                    }
+                    fill[*a] += aNeighbors.size() - common.size();
+                    fill[*b] += bNeighbors.size() - common.size();
+                }
+                aNeighbors.insert(at, *b);
+                bNeighbors.insert(std::lower_bound(bNeighbors.begin(), bNeighbors.end(), *a), *a);
+            }
+        }
+        for (const auto neighbor : neighbors)
+        {
+            auto &own = adjacency[neighbor];
+            // the lost missing edges are the ones to the neighbors outside of the clique
+            if (!fill.empty())
+            {
+                fill[neighbor] -= own.size() - neighbors.size();
+            }
+            own.erase(std::lower_bound(own.begin(), own.end(), vertex));
+        }
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        changed.erase(std::remove(changed.begin(), changed.end(), vertex), changed.end());
+        return changed;
+    }
+
+private:
+    bool adjacent(int a, int b) const
+    {
+        return std::binary_search(adjacency[a].cbegin(), adjacency[a].cend(), b);
+    }
+
+    std::vector<std::vector<int>> adjacency;
+    std::vector<std::size_t> fill;
+};
+
+// one elimination: the order of the vertices and the neighbors every vertex had when it was eliminated
+struct Elimination
+{
+    std::vector<int> ordering;
+    std::vector<std::vector<int>> higherNeighbors;
+};
+
+/**
+ * Eliminates the vertices greedily, the next one has the fewest missing edges among its neighbors (min-fill-in, ties
+ * by degree) or the smallest degree (min-degree). Ties are broken by the vertex number, or randomly with a 'seed'.
+ */
+inline Elimination greedyElimination(const Graph& graph, EliminationHeuristic heuristic, std::uint64_t seed = 0)
+{
+    const auto minFill = heuristic == EliminationHeuristic::MinFill;
+    EliminationGraph eliminationGraph(graph, minFill);
+    std::vector<std::uint64_t> ties(graph.adjacency.size());
+    std::mt19937_64 random(seed);
+    for (std::size_t vertex = 0; vertex < ties.size(); ++vertex)
+    {
+        ties[vertex] = seed == 0 ? vertex : random();
+    }
+    using Key = std::tuple<std::size_t, std::size_t, std::uint64_t, int>;
+    const auto keyOf = [&](int vertex) -> Key
+    {
+        const auto degree = eliminationGraph.neighborsOf(vertex).size();
+        return { minFill ? eliminationGraph.fillOf(vertex) : degree, minFill ? degree : 0, ties[vertex], vertex };
+    };
+    std::set<Key> queue;
+    std::vector<Key> keys(graph.adjacency.size());
+    for (auto vertex = 1; vertex <= graph.vertexCount; ++vertex)
+    {
+        keys[vertex] = keyOf(vertex);
+        queue.insert(keys[vertex]);
+    }
+    Elimination elimination;
+    while (!queue.empty())
+    {
+        const auto vertex = std::get<3>(*queue.begin());
+        queue.erase(queue.begin());
+        elimination.ordering.push_back(vertex);
+        elimination.higherNeighbors.push_back(eliminationGraph.neighborsOf(vertex));
+        for (const auto changed : eliminationGraph.eliminate(vertex))
+        {
+            queue.erase(keys[changed]);
+            keys[changed] = keyOf(changed);
+            queue.insert(keys[changed]);
+        }
+    }
+    return elimination;
+}
+
+// eliminates the vertices in the given order
+inline Elimination orderedElimination(const Graph& graph, const std::vector<int>& ordering)
+{
+    EliminationGraph eliminationGraph(graph, false);
+    Elimination elimination{ ordering, {} };
+    for (const auto vertex : ordering)
+    {
+        elimination.higherNeighbors.push_back(eliminationGraph.neighborsOf(vertex));
+        eliminationGraph.eliminate(vertex);
+    }
+    return elimination;
+}
+
+/**
+ * The TD of an elimination: one bag per vertex with its higher neighbors, whose parent is the bag of the neighbor that
+ * is eliminated first. The roots of the components are chained, so the result is a tree.
+ */
+inline TreeDecomposition treeDecompositionOf(const Graph& graph, const Elimination& elimination)
+{
+    std::vector<std::size_t> position(graph.adjacency.size(), 0);
+    for (std::size_t i = 0; i < elimination.ordering.size(); ++i)
+    {
+        position[elimination.ordering[i]] = i;
+    }
+    TreeDecomposition td;
+    td.bags.emplace_back();
+    std::optional<std::size_t> lastRoot;
+    for (std::size_t i = 0; i < elimination.ordering.size(); ++i)
+    {
+        auto bag = elimination.higherNeighbors[i];
+        bag.insert(std::lower_bound(bag.begin(), bag.end(), elimination.ordering[i]), elimination.ordering[i]);
+        td.bags.push_back(std::move(bag));
+        const auto &neighbors = elimination.higherNeighbors[i];
+        if (neighbors.empty())
+        {
+            if (lastRoot.has_value())
+            {
+                td.edges.emplace_back(static_cast<int>(lastRoot.value() + 1), static_cast<int>(i + 1));
+            }
+            lastRoot = i;
+            continue;
+        }
+        const auto parent = *std::min_element(neighbors.cbegin(), neighbors.cend(),
+            [&position](int a, int b) { return position[a] < position[b]; });
+        td.edges.emplace_back(static_cast<int>(i + 1), static_cast<int>(position[parent] + 1));
+    }
+    return td;
+}
+
+/**
+ * Width of the TD of an elimination and the estimated DP cost of its bags (as estimatedCost: 3^|bag| each, a bag with
+ * c > 1 children adds c - 1 joins of 4^|bag|), smaller is better.
+ */
+inline std::pair<std::size_t, double> qualityOf(const Elimination& elimination)
+{
+    std::vector<std::size_t> position(elimination.ordering.size() + 1, 0);
+    for (std::size_t i = 0; i < elimination.ordering.size(); ++i)
+    {
+        position[elimination.ordering[i]] = i;
+    }
+    std::vector<std::size_t> children(elimination.ordering.size(), 0);
+    for (const auto &neighbors : elimination.higherNeighbors)
+    {
+        if (!neighbors.empty())
+        {
+            children[position[*std::min_element(neighbors.cbegin(), neighbors.cend(),
+                [&position](int a, int b) { return position[a] < position[b]; })]]++;
+        }
+    }
+    std::size_t width = 0;
+    double cost = 0;
+    for (std::size_t i = 0; i < elimination.ordering.size(); ++i)
+    {
+        const auto size = elimination.higherNeighbors[i].size() + 1;
+        width = std::max(width, size - 1);
+        cost += std::pow(3.0, size) + (children[i] > 1 ? (children[i] - 1) * std::pow(4.0, size) : 0);
+    }
+    return { width, cost };
+}
+
+} // namespace detail
+
+/**
+ * Minor-min-width: contracting an edge never increases the treewidth and the min degree of a graph bounds it from
+ * below, so the vertex of min degree is repeatedly contracted into its neighbor of min degree and the largest min
+ * degree seen is a lower bound.
+ */
+inline std::size_t treewidthLowerBound(const Graph& graph)
+{
+    std::vector<std::vector<int>> adjacency(graph.adjacency);
+    for (auto &neighbors : adjacency)
+    {
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    }
+    std::set<std::pair<std::size_t, int>> queue;
+    for (auto vertex = 1; vertex <= graph.vertexCount; ++vertex)
+    {
+        queue.emplace(adjacency[vertex].size(), vertex);
+    }
+    std::size_t bound = 0;
+    while (!queue.empty())
+    {
+        const auto [degree, vertex] = *queue.begin();
+        queue.erase(queue.begin());
+        bound = std::max(bound, degree);
+        if (degree == 0)
+        {
+            continue;
+        }
+        const auto &neighbors = adjacency[vertex];
+        const auto into = *std::min_element(neighbors.cbegin(), neighbors.cend(),
+            [&adjacency](int a, int b) { return adjacency[a].size() < adjacency[b].size(); });
+        // the neighbors of 'vertex' become neighbors of 'into'
+        for (const auto neighbor : neighbors)
+        {
+            queue.erase({ adjacency[neighbor].size(), neighbor });
+            auto &own = adjacency[neighbor];
+            own.erase(std::lower_bound(own.begin(), own.end(), vertex));
+            const auto at = std::lower_bound(own.begin(), own.end(), into);
+            if (neighbor != into && (at == own.end() || *at != into))
+            {
+                own.insert(at, into);
+            }
+        }
+        auto &target = adjacency[into];
+        std::vector<int> merged;
+        std::set_union(target.cbegin(), target.cend(), neighbors.cbegin(), neighbors.cend(), std::back_inserter(merged));
+        merged.erase(std::remove(merged.begin(), merged.end(), into), merged.end());
+        target = std::move(merged);
+        for (const auto neighbor : neighbors)
+        {
+            queue.emplace(adjacency[neighbor].size(), neighbor);
+        }
+        adjacency[vertex].clear();
+    }
+    return bound;
+}
+
+// the TD of eliminating the vertices of 'graph' in the given order (a permutation of 1..vertexCount)
+inline TreeDecomposition treeDecompositionOf(const Graph& graph, const std::vector<int>& ordering)
+{
+    return detail::treeDecompositionOf(graph, detail::orderedElimination(graph, ordering));
+}
+
+// estimated DP cost (see qualityOf) that one thread processes per second, measured on dense tables of 1-byte values
+constexpr double estimatedCostPerSecond = 1e9;
+// without a time limit the improvement phase runs for this share of the DP time that the best TD so far is estimated
+// to need, at most for maxImprovementSeconds
+constexpr double improvementShare = 0.25;
+constexpr double maxImprovementSeconds = 60;
+
+/**
+ * A TD of 'graph' from the better (by width, then by the estimated cost of its bags) of the min-fill-in and the
+ * min-degree ordering. Then min-fill-in is rerun with random tie-breaking until the width meets the lower bound, i.e. is
+ * optimal, or the time is up: after 'seconds' if given (0 keeps the greedy TD), otherwise after improvementShare of the
+ * estimated DP time of the best TD so far, so narrow TDs of easy graphs are taken at once and wide ones are improved
+ * for up to maxImprovementSeconds.
+ */
+inline HeuristicTreeDecomposition heuristicTreeDecomposition(const Graph& graph,
+    std::optional<double> seconds = std::nullopt)
+{
+    const auto start = std::chrono::steady_clock::now();
+    HeuristicTreeDecomposition result;
+    result.lowerBound = treewidthLowerBound(graph);
+    auto best = detail::greedyElimination(graph, EliminationHeuristic::MinFill);
+    auto bestQuality = detail::qualityOf(best);
+    const auto consider = [&](detail::Elimination elimination)
+    {
+        const auto quality = detail::qualityOf(elimination);
+        if (quality < bestQuality)
+        {
+            best = std::move(elimination);
+            bestQuality = quality;
+        }
+        ++result.orderings;
+    };
+    const auto timeLeft = [&]
+    {
+        const auto budget = seconds.has_value() ? seconds.value() :
+            std::min(maxImprovementSeconds, improvementShare * bestQuality.second / estimatedCostPerSecond);
+        return std::chrono::steady_clock::now() - start < std::chrono::duration<double>(budget);
+    };
+    result.orderings = 1;
+    consider(detail::greedyElimination(graph, EliminationHeuristic::MinDegree));
+    for (std::uint64_t seed = 1; bestQuality.first > result.lowerBound && timeLeft(); ++seed)
+    {
+        consider(detail::greedyElimination(graph, EliminationHeuristic::MinFill, seed));
+    }
+    result.td = detail::treeDecompositionOf(graph, best);
+    result.width = bestQuality.first;
+    result.estimatedCost = bestQuality.second;
+    return result;
+}
+
+// DPs that are estimated to take less are not worth a warning about the width of their TD
+constexpr double minWarningSeconds = 10;
+
+// whether the width is so far above the lower bound and the DP so slow that a longer improvement phase or an exact TD
+// may pay off
+inline bool farAboveLowerBound(const HeuristicTreeDecomposition& heuristic)
+{
+    return heuristic.width > heuristic.lowerBound + heuristic.lowerBound / 2 &&
+        heuristic.estimatedCost >= minWarningSeconds * estimatedCostPerSecond;
+}
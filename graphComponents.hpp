@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "minDominatingSet.hpp"
+
+/**
+ * Disconnected graphs: a minimum dominating set is the union of one of every connected component, so every component
+ * gets its own (narrower) TD and DP and independent components are solved concurrently. Components where one vertex
+ * dominates everything skip the TD and the DP.
+ */
+
+struct GraphComponent
+{
+    // the component, its vertices renumbered 1..vertexCount in the order of their ids in the whole graph
+    Graph graph;
+    // the id in the whole graph of every component vertex, original[0] stays 0
+    std::vector<int> original;
+    // component vertices that are dominated already (see minDominatingSet), empty for none
+    std::vector<bool> dominated;
+};
+
+// the connected components of 'graph' by their smallest vertex, 'dominated' (indexed by vertex id) may be empty
+inline std::vector<GraphComponent> connectedComponents(const Graph& graph, const std::vector<bool>& dominated = {})
+{
+    std::vector<std::size_t> componentOf(graph.vertexCount + 1, 0);
+    std::vector<int> number(graph.vertexCount + 1, 0);
+    std::vector<GraphComponent> components;
+    for (int start = 1; start <= graph.vertexCount; ++start)
+    {
+        if (number[start] != 0)
+        {
+            continue;
+        }
+        components.emplace_back();
+        auto &component = components.back();
+        component.original = { 0, start };
+        number[start] = 1;
+        for (std::size_t i = 1; i < component.original.size(); ++i)
+        {
+            for (const auto neighbor : graph.adjacency[component.original[i]])
+            {
+                if (number[neighbor] == 0)
+                {
+                    number[neighbor] = 1;
+                    component.original.push_back(neighbor);
+                }
+            }
+        }
+        std::sort(component.original.begin() + 1, component.original.end());
+        for (std::size_t i = 1; i < component.original.size(); ++i)
+        {
+            number[component.original[i]] = static_cast<int>(i);
+            componentOf[component.original[i]] = components.size() - 1;
+        }
+        component.graph.vertexCount = static_cast<int>(component.original.size()) - 1;
+        component.graph.adjacency.resize(component.original.size());
+        if (!dominated.empty())
+        {
+            component.dominated.resize(component.original.size(), false);
+            for (std::size_t i = 1; i < component.original.size(); ++i)
+            {
+                component.dominated[i] = dominated[component.original[i]];
+            }
+        }
+    }
+    for (int vertex = 1; vertex <= graph.vertexCount; ++vertex)
+    {
+        auto &component = components[componentOf[vertex]];
+        for (const auto neighbor : graph.adjacency[vertex])
+        {
+            component.graph.adjacency[number[vertex]].push_back(number[neighbor]);
+        }
+    }
+    for (const auto &[u, v] : graph.edges)
+    {
+        components[componentOf[u]].graph.edges.emplace_back(number[u], number[v]);
+    }
+    return components;
+}
+
+// a minimum dominating set (by component ids) if no vertex or one vertex suffices, nothing otherwise
+inline std::optional<std::vector<int>> trivialDominatingSet(const GraphComponent& component)
+{
+    const auto needsDomination = [&component](int vertex)
+    {
+        return component.dominated.empty() || !component.dominated[vertex];
+    };
+    std::size_t undominated = 0;
+    for (int vertex = 1; vertex <= component.graph.vertexCount; ++vertex)
+    {
+        undominated += needsDomination(vertex);
+    }
+    if (undominated == 0)
+    {
+        return std::vector<int>{};
+    }
+    // the adjacency may list an edge twice, 'seen' counts every neighbor once per vertex
+    std::vector<int> seen(component.graph.vertexCount + 1, 0);
+    for (int vertex = 1; vertex <= component.graph.vertexCount; ++vertex)
+    {
+        std::size_t dominates = needsDomination(vertex);
+        seen[vertex] = vertex;
+        for (const auto neighbor : component.graph.adjacency[vertex])
+        {
+            dominates += seen[neighbor] != vertex && needsDomination(neighbor);
+            seen[neighbor] = vertex;
+        }
+        if (dominates == undominated)
+        {
+            return std::vector<int>{ vertex };
+        }
+    }
+    return std::nullopt;
+}
+
+struct ComponentsResult
+{
+    // the sums over the components, the dominating set by the ids of the whole graph. The peak of the live tables is
+    // measured over all components, including the ones that are solved at the same time
+    DominatingSetResult result{};
+    std::size_t trivial = 0;
+    // solved one after the other with all threads, the DP of each of them is at least a 1/threads share of all
+    std::size_t alone = 0;
+    // the other components are solved in batches of at least minBatchCost, one batch per worker at a time
+    std::size_t concurrent = 0;
+    std::size_t batches = 0;
+};
+
+namespace detail
+{
+
+// estimatedCost of a batch of small components that is handed to one worker, the components of a batch run one after
+// the other and reuse the pooled table buffers
+constexpr double minBatchCost = static_cast<double>(indexed::parallelThreshold);
+
+// adds the result of a component to the sums
+inline void addComponentResult(ComponentsResult& sums, const GraphComponent& component, const DominatingSetResult& result)
+{
+    auto &total = sums.result;
+    total.size += result.size;
+    for (const auto vertex : result.dominatingSet)
+    {
+        total.dominatingSet.push_back(component.original[vertex]);
+    }
+    for (std::size_t engine = 0; engine < total.engineBags.size(); ++engine)
+    {
+        total.engineBags[engine] += result.engineBags[engine];
+    }
+    total.upperBound += result.upperBound;
+    total.prunedStates += result.prunedStates;
+    total.valueBytes = std::max(total.valueBytes, result.valueBytes);
+    total.spilledBytes += result.spilledBytes;
+}
+
+} // namespace detail
+
+/**
+ * Solves every component with minDominatingSet (see there for the options), 'niceTDs' holds the labelled nice-TD of
+ * every component, an empty one for trivial components (see trivialDominatingSet). Components whose estimated DP
+ * cost is at least a 1/threadCount share of the total go first, one after the other with all threads, the others
+ * are batched by cost and the batches are solved concurrently.
+ */
+inline ComponentsResult solveComponents(const std::vector<GraphComponent>& components,
+    const std::vector<std::vector<NiceBag>>& niceTDs, std::size_t threadCount = 1, WitnessOptions witness = {},
+    EngineChoice engines = EngineChoice::Auto, bool prune = false, const std::string& spillDirectory = {})
+{
+    ComponentsResult sums;
+    std::vector<std::pair<double, std::size_t>> costs;
+    double totalCost = 0;
+    for (std::size_t i = 0; i < components.size(); ++i)
+    {
+        if (niceTDs[i].empty())
+        {
+            const auto trivial = trivialDominatingSet(components[i]);
+            if (!trivial.has_value())
+            {
+                throw std::invalid_argument("component " + std::to_string(i) + " needs a nice-TD");
+            }
+            const auto size = static_cast<int>(trivial->size());
+            detail::addComponentResult(sums, components[i],
+                { size, 0, witness.enabled ? trivial.value() : std::vector<int>{}, {}, size });
+            sums.trivial++;
+            continue;
+        }
+        costs.emplace_back(estimatedCost(niceTDs[i]), i);
+        totalCost += costs.back().first;
+    }
+    std::sort(costs.begin(), costs.end(), std::greater<>());
+
+    // all components share the tables, so their peak is the one of all live tables of concurrent components
+    indexed::TableMemory tables;
+    auto next = costs.cbegin();
+    for (; next != costs.cend() && next->first * static_cast<double>(threadCount) >= totalCost; ++next)
+    {
+        const auto result = minDominatingSet(niceTDs[next->second], threadCount, witness, engines, prune, &tables,
+            spillDirectory, nullptr, {}, components[next->second].dominated);
+        detail::addComponentResult(sums, components[next->second], result);
+        sums.alone++;
+    }
+
+    // consecutive components by decreasing cost, so the batches of the largest ones start first
+    std::vector<std::vector<std::size_t>> batches;
+    double batchCost = detail::minBatchCost;
+    for (; next != costs.cend(); ++next)
+    {
+        if (batchCost >= detail::minBatchCost)
+        {
+            batches.emplace_back();
+            batchCost = 0;
+        }
+        batches.back().push_back(next->second);
+        batchCost += next->first;
+        sums.concurrent++;
+    }
+    sums.batches = batches.size();
+    std::vector<DominatingSetResult> results(components.size());
+    // the first error of a worker is thrown once all of them are done
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    indexed::parallelFor(batches.size(), threadCount, [&](std::size_t batch)
+    {
+        try
+        {
+            for (const auto i : batches[batch])
+            {
+                results[i] = minDominatingSet(niceTDs[i], 1, witness, engines, prune, &tables, spillDirectory, nullptr,
+                    {}, components[i].dominated);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            error = error != nullptr ? error : std::current_exception();
+        }
+    });
+    if (error != nullptr)
+    {
+        std::rethrow_exception(error);
+    }
+    for (const auto &batch : batches)
+    {
+        for (const auto i : batch)
+        {
+            detail::addComponentResult(sums, components[i], results[i]);
+        }
+    }
+    sums.result.peakTableBytes = tables.overallPeakBytes;
+    std::sort(sums.result.dominatingSet.begin(), sums.result.dominatingSet.end());
+    return sums;
+}
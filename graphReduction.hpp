@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "treeDecomposition.hpp"
+
+/**
+ * Data reduction for the minimum dominating set before the TD is built: rules that take vertices into the solution or
+ * remove vertices that some minimum dominating set does not need, so that the DP only runs on the (usually much
+ * smaller and narrower) kernel. Removed vertices whose neighbors are taken stay dominated, the kernel is an annotated
+ * instance: its dominated vertices do not need a black neighbor (see the 'dominated' argument of minDominatingSet).
+ *
+ * The rules, applied until none of them changes the graph (D are the dominated vertices):
+ * - an isolated vertex is taken, unless it is in D, then it is removed
+ * - the single-vertex rule of Alber, Fellows and Niedermeier: N1 are the neighbors of v with a neighbor outside of
+ *   N[v], N2 the other neighbors with a neighbor in N1, N3 the rest. If N3 has a vertex outside of D, only vertices
+ *   of N[v] can dominate it and v dominates everything they do: v is taken, v, N2 and N3 are removed and N1 goes
+ *   into D (this covers the leaf rule, a leaf is in N3 of its neighbor)
+ * - an edge between two vertices of D is removed, neither of them needs it
+ * - a vertex of D with at most one neighbor is removed, the neighbor dominates as much
+ * - twins: of vertices with the same closed neighborhood only one is kept (one outside of D if there is one), and a
+ *   vertex of D is removed if another vertex has the same open neighborhood
+ * Alber et al.'s pair rule is not applied, it would need vertices that are taken together with one of two choices.
+ * The rules are for unit weights only.
+ */
+
+struct ReductionCounts
+{
+    // applications of each rule
+    std::size_t isolated = 0;
+    std::size_t singleVertex = 0;
+    std::size_t dominatedEdges = 0;
+    std::size_t dominatedVertices = 0;
+    std::size_t twins = 0;
+};
+
+struct ReducedGraph
+{
+    // the kernel, its vertices are renumbered 1..vertexCount in the order of their original ids
+    Graph graph;
+    // the original id of every kernel vertex, original[0] stays 0
+    std::vector<int> original;
+    // kernel vertices (by kernel id) that are dominated by a taken vertex already
+    std::vector<bool> dominated;
+    // original ids of the vertices that the rules took into the solution, a minimum dominating set of the original
+    // graph is these vertices plus one of the kernel (with 'dominated' as given)
+    std::vector<int> forced;
+    ReductionCounts counts;
+};
+
+namespace detail
+{
+
+// the graph while the rules remove vertices and edges, with the sorted adjacency of the remaining vertices
+class ReductionGraph
+{
+public:
+    explicit ReductionGraph(const Graph& graph) :
+        adjacency(graph.adjacency), alive(adjacency.size(), true), dominated(adjacency.size(), false),
+        marks(adjacency.size(), 0)
+    {
+        alive[0] = false;
+        for (std::size_t vertex = 0; vertex < adjacency.size(); ++vertex)
+        {
+            auto &neighbors = adjacency[vertex];
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), static_cast<int>(vertex)), neighbors.end());
+        }
+    }
+
+    // applies the rules that look at the neighborhood of 'vertex', returns whether the graph changed
+    bool reduceAt(int vertex)
+    {
+        if (!alive[vertex])
+        {
+            return false;
+        }
+        if (dominated[vertex])
+        {
+            std::vector<int> dominatedNeighbors;
+            std::copy_if(adjacency[vertex].cbegin(), adjacency[vertex].cend(), std::back_inserter(dominatedNeighbors),
+                [this](int neighbor) { return dominated[neighbor]; });
+            for (const auto neighbor : dominatedNeighbors)
+            {
+                removeEdge(vertex, neighbor);
+                counts.dominatedEdges++;
+            }
+            if (adjacency[vertex].size() == 1)
+            {
+                removeVertex(vertex);
+                counts.dominatedVertices++;
+                return true;
+            }
+            if (!dominatedNeighbors.empty())
+            {
+                return true;
+            }
+        }
+        if (adjacency[vertex].empty())
+        {
+            if (!dominated[vertex])
+            {
+                forced.push_back(vertex);
+            }
+            removeVertex(vertex);
+            counts.isolated++;
+            return true;
+        }
+        return singleVertexRule(vertex);
+    }
+
+    // the twin rules on all remaining vertices, returns whether the graph changed
+    bool reduceTwins()
+    {
+        std::map<std::vector<int>, std::vector<int>> closed;
+        std::map<std::vector<int>, std::vector<int>> open;
+        for (std::size_t vertex = 1; vertex < adjacency.size(); ++vertex)
+        {
+            if (!alive[vertex])
+            {
+                continue;
+            }
+            open[adjacency[vertex]].push_back(static_cast<int>(vertex));
+            auto neighborhood = adjacency[vertex];
+            neighborhood.insert(std::lower_bound(neighborhood.begin(), neighborhood.end(), static_cast<int>(vertex)),
+                static_cast<int>(vertex));
+            closed[std::move(neighborhood)].push_back(static_cast<int>(vertex));
+        }
+        // removing a vertex keeps the others of both kinds of groups twins, so all groups are reduced at once
+        std::vector<int> removed;
+        for (const auto &[neighborhood, twins] : closed)
+        {
+            const auto kept = std::find_if(twins.cbegin(), twins.cend(), [this](int twin) { return !dominated[twin]; });
+            const auto keep = kept != twins.cend() ? *kept : twins.front();
+            std::copy_if(twins.cbegin(), twins.cend(), std::back_inserter(removed), [keep](int twin) { return twin != keep; });
+        }
+        for (const auto &[neighborhood, twins] : open)
+        {
+            const auto kept = std::find_if(twins.cbegin(), twins.cend(), [this](int twin) { return !dominated[twin]; });
+            const auto keep = kept != twins.cend() ? *kept : twins.front();
+            std::copy_if(twins.cbegin(), twins.cend(), std::back_inserter(removed),
+                [this, keep](int twin) { return twin != keep && dominated[twin]; });
+        }
+        auto changed = false;
+        for (const auto vertex : removed)
+        {
+            if (alive[vertex])
+            {
+                removeVertex(vertex);
+                counts.twins++;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    ReducedGraph kernel() const
+    {
+        ReducedGraph reduced;
+        std::vector<int> number(adjacency.size(), 0);
+        reduced.original.push_back(0);
+        for (std::size_t vertex = 1; vertex < adjacency.size(); ++vertex)
+        {
+            if (alive[vertex])
+            {
+                number[vertex] = static_cast<int>(reduced.original.size());
+                reduced.original.push_back(static_cast<int>(vertex));
+            }
+        }
+        reduced.graph.vertexCount = static_cast<int>(reduced.original.size()) - 1;
+        reduced.graph.adjacency.resize(reduced.original.size());
+        reduced.dominated.resize(reduced.original.size(), false);
+        for (std::size_t kernelVertex = 1; kernelVertex < reduced.original.size(); ++kernelVertex)
+        {
+            const auto vertex = reduced.original[kernelVertex];
+            reduced.dominated[kernelVertex] = dominated[vertex];
+            for (const auto neighbor : adjacency[vertex])
+            {
+                reduced.graph.adjacency[kernelVertex].push_back(number[neighbor]);
+                if (vertex < neighbor)
+                {
+                    reduced.graph.edges.emplace_back(static_cast<int>(kernelVertex), number[neighbor]);
+                }
+            }
+        }
+        reduced.forced = forced;
+        std::sort(reduced.forced.begin(), reduced.forced.end());
+        reduced.counts = counts;
+        return reduced;
+    }
+
+private:
+    bool singleVertexRule(int vertex)
+    {
+        // marks: 1 for N(v), 2 for the exits N1, v itself is not marked
+        const auto &neighbors = adjacency[vertex];
+        for (const auto neighbor : neighbors)
+        {
+            marks[neighbor] = 1;
+        }
+        for (const auto neighbor : neighbors)
+        {
+            // stops at the first neighbor outside of N[v], at most |N[v]| steps
+            const auto exit = std::any_of(adjacency[neighbor].cbegin(), adjacency[neighbor].cend(),
+                [this, vertex](int other) { return other != vertex && marks[other] == 0; });
+            if (exit)
+            {
+                marks[neighbor] = 2;
+            }
+        }
+        std::vector<int> inner;
+        auto needed = false;
+        for (const auto neighbor : neighbors)
+        {
+            if (marks[neighbor] == 2)
+            {
+                continue;
+            }
+            inner.push_back(neighbor);
+            const auto guard = std::any_of(adjacency[neighbor].cbegin(), adjacency[neighbor].cend(),
+                [this](int other) { return marks[other] == 2; });
+            needed = needed || (!guard && !dominated[neighbor]);
+        }
+        std::vector<int> exits;
+        for (const auto neighbor : neighbors)
+        {
+            if (marks[neighbor] == 2)
+            {
+                exits.push_back(neighbor);
+            }
+            marks[neighbor] = 0;
+        }
+        if (!needed)
+        {
+            return false;
+        }
+        forced.push_back(vertex);
+        removeVertex(vertex);
+        for (const auto neighbor : inner)
+        {
+            removeVertex(neighbor);
+        }
+        for (const auto neighbor : exits)
+        {
+            dominated[neighbor] = true;
+        }
+        counts.singleVertex++;
+        return true;
+    }
+
+    void removeEdge(int u, int v)
+    {
+        adjacency[u].erase(std::lower_bound(adjacency[u].begin(), adjacency[u].end(), v));
+        adjacency[v].erase(std::lower_bound(adjacency[v].begin(), adjacency[v].end(), u));
+    }
+
+    void removeVertex(int vertex)
+    {
+        for (const auto neighbor : adjacency[vertex])
+        {
+            auto &other = adjacency[neighbor];
+            other.erase(std::lower_bound(other.begin(), other.end(), vertex));
+        }
+        adjacency[vertex].clear();
+        alive[vertex] = false;
+    }
+
+    std::vector<std::vector<int>> adjacency;
+    std::vector<bool> alive;
+    std::vector<bool> dominated;
+    std::vector<std::uint8_t> marks;
+    std::vector<int> forced;
+    ReductionCounts counts;
+};
+
+} // namespace detail
+
+// applies the rules (see above) to 'graph' until none of them applies
+inline ReducedGraph reduceGraph(const Graph& graph)
+{
+    detail::ReductionGraph reduction(graph);
+    for (auto changed = true; changed;)
+    {
+        changed = false;
+        for (int vertex = 1; vertex <= graph.vertexCount; ++vertex)
+        {
+            // a vertex that changed may allow another rule at once
+            while (reduction.reduceAt(vertex))
+            {
+                changed = true;
+            }
+        }
+        changed = reduction.reduceTwins() || changed;
+    }
+    return reduction.kernel();
+}
+
+/**
+ * The TD that 'td' induces on a subgraph whose vertex i is the vertex original[i] of the graph of 'td' (as the kernel of
+ * ReducedGraph, original[0] is not used), with the other vertices dropped from the bags. 'original' has to be sorted.
+ */
+inline TreeDecomposition restrictTreeDecomposition(const TreeDecomposition& td, const std::vector<int>& original)
+{
+    std::map<int, int> number;
+    for (std::size_t vertex = 1; vertex < original.size(); ++vertex)
+    {
+        number[original[vertex]] = static_cast<int>(vertex);
+    }
+    auto restricted = td;
+    for (auto &bag : restricted.bags)
+    {
+        std::vector<int> kept;
+        for (const auto vertex : bag)
+        {
+            const auto it = number.find(vertex);
+            if (it != number.cend())
+            {
+                kept.push_back(it->second);
+            }
+        }
+        // the renumbering keeps the order of the vertices
+        bag = std::move(kept);
+    }
+    // bags that lost all of their vertices are merged into a neighbor
+    return mergeRedundantBags(restricted);
+}
+
+// the original ids of a dominating set of the kernel, together with the taken vertices
+inline std::vector<int> originalDominatingSet(const ReducedGraph& reduced, const std::vector<int>& kernelSet)
+{
+    auto dominatingSet = reduced.forced;
+    for (const auto vertex : kernelSet)
+    {
+        dominatingSet.push_back(reduced.original[vertex]);
+    }
+    std::sort(dominatingSet.begin(), dominatingSet.end());
+    return dominatingSet;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "minDominatingSet.hpp"
+
+/**
+ * Incremental re-solve for graphs that change by a few edges between runs: the nice-TD and the tables of all of its
+ * bags are kept after the first DP. An edit only moves introduce edges between bags (an added edge is introduced at the
+ * bag closest to the root that contains both endpoints, a removed one is taken out of its bag), so every table below
+ * the changed bags is still valid and only the bags on their paths to the root are recomputed.
+ * An added edge between vertices that share no bag needs a new TD, the vertex set is fixed.
+ */
+namespace detail
+{
+
+template<typename Value>
+class IncrementalSolver
+{
+public:
+    IncrementalSolver(const std::vector<NiceBag>& niceBags, std::size_t threadCount, EngineChoice engines) :
+        bags(makeBags<Value>(niceBags)), depth(bags.size(), 0), threadCount(threadCount), engines(engines)
+    {
+        for (std::size_t number = 1; number < bags.size(); ++number)
+        {
+            depth[number] = depth[bags[number].parentNumber.value()] + 1;
+        }
+        for (const auto &bag : bags)
+        {
+            for (const auto &edge : bag.introduceEdges)
+            {
+                edgeBags[normalized(edge)] = bag.number;
+            }
+        }
+        // children have larger numbers, so a descending pass sees them first
+        for (auto number = bags.size(); number-- > 0;)
+        {
+            processBag(bags, number, memory, threadCount, false, engines);
+        }
+    }
+
+    int size() const
+    {
+        const auto rootValue = bags[0].c.front();
+        return rootValue == indexed::infinity<Value> ? std::numeric_limits<int>::max() : static_cast<int>(rootValue);
+    }
+
+    std::size_t tableBytes() const
+    {
+        return memory.liveBytes;
+    }
+
+    std::size_t update(const std::vector<std::pair<int, int>>& added, const std::vector<std::pair<int, int>>& removed)
+    {
+        // all edits are checked before the first one is applied, removals go first
+        std::vector<std::pair<int, int>> removals;
+        for (const auto &edge : removed)
+        {
+            const auto key = normalized(edge);
+            if (edgeBags.count(key) == 0 || std::find(removals.cbegin(), removals.cend(), key) != removals.cend())
+            {
+                throw std::invalid_argument("edge " + toString(edge) + " is not in the graph");
+            }
+            removals.push_back(key);
+        }
+        std::vector<std::pair<std::pair<int, int>, BagNumber>> additions;
+        for (const auto &edge : added)
+        {
+            const auto key = normalized(edge);
+            const auto present = (edgeBags.count(key) > 0 &&
+                std::find(removals.cbegin(), removals.cend(), key) == removals.cend()) ||
+                std::any_of(additions.cbegin(), additions.cend(), [&key](const auto& addition) { return addition.first == key; });
+            if (key.first == key.second || present)
+            {
+                throw std::invalid_argument("edge " + toString(edge) + " is a loop or already in the graph");
+            }
+            additions.emplace_back(key, highestBagWith(key));
+        }
+
+        std::vector<bool> changed(bags.size(), false);
+        for (const auto &key : removals)
+        {
+            const auto it = edgeBags.find(key);
+            auto &bag = bags[it->second];
+            auto edges = bag.introduceEdges;
+            edges.erase(std::find_if(edges.begin(), edges.end(),
+                [&it](const std::pair<int, int>& e) { return normalized(e) == it->first; }));
+            bag.setIntroduceEdges(std::move(edges));
+            changed[bag.number] = true;
+            edgeBags.erase(it);
+        }
+        for (const auto &[edge, number] : additions)
+        {
+            auto edges = bags[number].introduceEdges;
+            edges.push_back(edge);
+            bags[number].setIntroduceEdges(std::move(edges));
+            changed[number] = true;
+            edgeBags[edge] = number;
+        }
+
+        // a changed bag invalidates the tables of all of its ancestors, parents have smaller numbers
+        for (std::size_t number = bags.size(); number-- > 1;)
+        {
+            changed[bags[number].parentNumber.value()] = changed[bags[number].parentNumber.value()] || changed[number];
+        }
+        std::size_t recomputed = 0;
+        for (auto number = bags.size(); number-- > 0;)
+        {
+            if (changed[number])
+            {
+                bags[number].releaseState(memory);
+                processBag(bags, number, memory, threadCount, false, engines);
+                ++recomputed;
+            }
+        }
+        return recomputed;
+    }
+
+private:
+    static std::pair<int, int> normalized(const std::pair<int, int>& edge)
+    {
+        return { std::min(edge.first, edge.second), std::max(edge.first, edge.second) };
+    }
+
+    static std::string toString(const std::pair<int, int>& edge)
+    {
+        return std::to_string(edge.first) + "-" + std::to_string(edge.second);
+    }
+
+    // the bag closest to the root with both endpoints, its path to the root is the shortest one to recompute
+    BagNumber highestBagWith(const std::pair<int, int>& edge) const
+    {
+        std::optional<BagNumber> best;
+        for (const auto &bag : bags)
+        {
+            const auto contains = [&bag](int vertex)
+            {
+                return std::find(bag.bagElements.cbegin(), bag.bagElements.cend(), vertex) != bag.bagElements.cend();
+            };
+            if (bag.type != BagType::Leaf && contains(edge.first) && contains(edge.second) &&
+                (!best.has_value() || depth[bag.number] < depth[best.value()]))
+            {
+                best = bag.number;
+            }
+        }
+        if (!best.has_value())
+        {
+            throw std::invalid_argument("no bag contains both endpoints of " + toString(edge) + ", the TD has to be rebuilt");
+        }
+        return best.value();
+    }
+
+    Bags<Value> bags;
+    std::vector<std::size_t> depth;
+    // the bag that introduces every edge, by its smaller endpoint first
+    std::map<std::pair<int, int>, BagNumber> edgeBags;
+    indexed::TableMemory memory;
+    std::size_t threadCount;
+    EngineChoice engines;
+};
+
+} // namespace detail
+
+/**
+ * Solves a labelled nice-TD (see minDominatingSet) and keeps all of its tables, so that 'update' can re-solve after a
+ * few edges are added or removed by recomputing only the bags above the edited ones. Only the size is maintained
+ * (no witness, no pruning: the greedy bound depends on the graph). Memory is the sum of all tables of the nice-TD.
+ */
+class IncrementalDominatingSet
+{
+public:
+    explicit IncrementalDominatingSet(const std::vector<NiceBag>& niceBags, std::size_t threadCount = 1,
+        EngineChoice engines = EngineChoice::Auto) :
+        solver(makeSolver(niceBags, threadCount, engines))
+    {
+    }
+
+    // size of a minimum dominating set of the current graph
+    int size() const
+    {
+        return std::visit([](const auto& solver) { return solver.size(); }, solver);
+    }
+
+    // bytes of all tables that are kept
+    std::size_t tableBytes() const
+    {
+        return std::visit([](const auto& solver) { return solver.tableBytes(); }, solver);
+    }
+
+    /**
+     * Adds and removes edges between vertices of the nice-TD and re-solves, returns the number of recomputed bags.
+     * Throws std::invalid_argument (and changes nothing) if a removed edge is not in the graph, an added one already is,
+     * or no bag contains both endpoints of an added edge.
+     */
+    std::size_t update(const std::vector<std::pair<int, int>>& added, const std::vector<std::pair<int, int>>& removed)
+    {
+        return std::visit([&](auto& solver) { return solver.update(added, removed); }, solver);
+    }
+
+private:
+    using Solver = std::variant<detail::IncrementalSolver<std::uint8_t>, detail::IncrementalSolver<std::uint16_t>,
+        detail::IncrementalSolver<std::uint32_t>>;
+
+    // the same value types as minDominatingSet, edits do not change the number of vertices
+    static Solver makeSolver(const std::vector<NiceBag>& niceBags, std::size_t threadCount, EngineChoice engines)
+    {
+        const auto vertexCount = detail::NiceTDGraph(niceBags).vertices.size();
+        if (vertexCount < indexed::infinity<std::uint8_t>)
+        {
+            return Solver(std::in_place_index<0>, niceBags, threadCount, engines);
+        }
+        if (vertexCount < indexed::infinity<std::uint16_t>)
+        {
+            return Solver(std::in_place_index<1>, niceBags, threadCount, engines);
+        }
+        return Solver(std::in_place_index<2>, niceBags, threadCount, engines);
+    }
+
+    Solver solver;
+};
@@ -0,0 +1,1137 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX512F__)
+// GCC 12 warns about the _mm512_undefined_epi32 placeholders inside the intrinsics wherever they are inlined
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+
+/************************************************************************************************************************/
+/* Colors used in the algorithm */
+enum class Color : std::uint8_t
+{
+    // a white vertex means, that in the current sub-problem it is not added to the dominating set
+    // -> must be dominated in the partial solution
+    White = 0,
+    // a black vertex means, that in the current sub-problem it is added to the dominating set
+    // -> must dominate all white vertices of the partial solution
+    Black = 1,
+    // a grey vertex means, that this vertex is not part of the current solution
+    // -> does not have to be dominated in the partial solution, but might be
+    Grey = 2
+};
+constexpr Color colorArr[] = { Color::White, Color::Black, Color::Grey }; // use for easy iteration
+constexpr std::tuple<Color, Color, Color> consistentColorsArr[] = {
+    std::make_tuple(Color::Black, Color::Black, Color::Black),
+    std::make_tuple(Color::White, Color::White, Color::Grey),
+    std::make_tuple(Color::White, Color::Grey, Color::White),
+    std::make_tuple(Color::Grey, Color::Grey, Color::Grey)
+};
+
+/************************************************************************************************************************/
+/**
+ * Dense table engine: the state of a bag with k vertices is a flat array of 3^k values.
+ * A coloring is never materialized, it is identified by its base-3 index, where the i-th digit is the color
+ * of the i-th vertex of the bag in its digit order. The digit orders are derived from the root down (see makeBags in
+ * minDominatingSet.hpp): a bag keeps the relative order of the vertices it shares with its parent, and the vertex that
+ * the parent forgets is its highest digit. So the vertices shared by a bag and its child appear in the same relative
+ * order in both, a forget is a min over the three contiguous slices of the child table, the children of a join have
+ * the order of the join, and every kernel is pure index arithmetic.
+ */
+namespace indexed
+{
+
+/**
+ * Values are sizes (with vertex weights: weights) of partial solutions, which never exceed the number of vertices (the
+ * total weight) of the graph. Tables store them in the narrowest unsigned type that can hold this number (uint8, uint16
+ * or uint32, picked by minDominatingSet), so the kernels move 2-4x less memory than with 32-bit values on graphs with
+ * less than 255 or 65535 vertices.
+ * max() is treated as infinity, i.e. there is no partial solution for this coloring.
+ */
+template<typename Value>
+constexpr Value infinity = std::numeric_limits<Value>::max();
+
+template<typename Value>
+using Table = std::vector<Value>;
+
+// backpointers for reconstructing a solution, one entry per coloring of the bag:
+// forget bags store 1 if the forgotten vertex is black in the best child coloring (0 if it is white),
+// join bags store a bitmask with bit i set if the white digit i is white in the first child (and grey in the second)
+using ForgetChoices = std::vector<std::uint8_t>;
+using JoinChoices = std::vector<std::uint32_t>;
+
+// 3^20 is the largest power of 3 that fits into 32 bit indices
+constexpr std::size_t maxBagSize = 20;
+
+/**
+ * Cost of a black vertex, a compile-time policy of the introduce and join kernels (the only ones that add costs), by
+ * the position of the vertex in the bag of the table. UnitCost counts every black vertex once, its constant folds into
+ * the kernels. VertexCost adds the weight of the vertex (minimum weight dominating set), 'weights' holds the weights of
+ * the vertices of the bag in bag order. All other kernels only compare values, so they serve both.
+ */
+struct UnitCost
+{
+    constexpr std::uint32_t operator[](std::size_t) const
+    {
+        return 1;
+    }
+};
+
+struct VertexCost
+{
+    const std::uint32_t* weights = nullptr;
+
+    std::uint32_t operator[](std::size_t position) const
+    {
+        return weights[position];
+    }
+};
+
+constexpr std::array<std::size_t, maxBagSize + 2> pow3Arr = []()
+{
+    std::array<std::size_t, maxBagSize + 2> arr{};
+    arr[0] = 1;
+    for (std::size_t i = 1; i < arr.size(); ++i)
+    {
+        arr[i] = 3 * arr[i - 1];
+    }
+    return arr;
+}();
+
+inline std::size_t pow3(std::size_t exponent)
+{
+    assert(exponent < pow3Arr.size());
+    return pow3Arr[exponent];
+}
+
+/**
+ * Accounts for the memory of all tables alive at the same time. Tables are only allocated once the traversal reaches
+ * their bag and released as soon as the parent has consumed them, so the peak depends on the width of the TD and the
+ * number of pending join branches, not on the total number of bags.
+ * It is also the allocator of the tables: released buffers of 3^k entries (dense tables and backpointers) are kept in
+ * a pool per entry type and k and handed out again, so after the first bags of a size the DP neither calls malloc nor
+ * touches fresh pages for them. The pool holds at most the peak of the live tables, a TableMemory can be reused across
+ * runs (see minDominatingSet) to keep it warm.
+ */
+struct TableMemory
+{
+    std::size_t liveBytes = 0;
+    // the peak since the last resetPeak
+    std::size_t peakBytes = 0;
+    // the peak since construction, of all runs that shared the tables (e.g. concurrent ones)
+    std::size_t overallPeakBytes = 0;
+    std::size_t pooledBytes = 0;
+    // bags are processed concurrently by the scheduler
+    std::mutex mutex;
+
+    template<typename Entry>
+    using Pool = std::array<std::vector<std::vector<Entry>>, maxBagSize + 1>;
+    // Table<Value> entries and backpointers (uint8 forget and uint32 join choices) share the pools of their type
+    std::tuple<Pool<std::uint8_t>, Pool<std::uint16_t>, Pool<std::uint32_t>> pools;
+
+    template<typename Value>
+    void allocate(Table<Value>& table, std::size_t bagsize)
+    {
+        allocateFilled(table, bagsize, infinity<Value>);
+    }
+
+    // for tables whose size is only known once they are filled (sparse tables), released entry-wise like the others
+    void account(std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        addLive(bytes);
+    }
+
+    // backpointers are accounted like tables, entries start as 0
+    template<typename Entry>
+    void allocateChoices(std::vector<Entry>& choices, std::size_t bagsize)
+    {
+        allocateFilled(choices, bagsize, Entry{ 0 });
+    }
+
+    template<typename Entry>
+    void release(std::vector<Entry>& table)
+    {
+        const auto bytes = table.capacity() * sizeof(Entry);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            assert(liveBytes >= bytes);
+            liveBytes -= bytes;
+            // only buffers of exactly 3^k entries fit a size class, sparse tables are freed
+            const auto bagsize = static_cast<std::size_t>(std::find(pow3Arr.cbegin(), pow3Arr.cend(), table.capacity()) -
+                pow3Arr.cbegin());
+            if (table.capacity() > 1 && bagsize <= maxBagSize && pooledBytes + bytes <= peakBytes)
+            {
+                std::get<Pool<Entry>>(pools)[bagsize].push_back(std::move(table));
+                pooledBytes += bytes;
+                table = std::vector<Entry>();
+                return;
+            }
+        }
+        std::vector<Entry>().swap(table);
+    }
+
+    // starts the accounting of a new run, the pool is kept
+    void resetPeak()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        peakBytes = liveBytes;
+    }
+
+private:
+    template<typename Entry>
+    void allocateFilled(std::vector<Entry>& table, std::size_t bagsize, Entry value)
+    {
+        assert(table.empty());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto &pool = std::get<Pool<Entry>>(pools)[bagsize];
+            if (!pool.empty())
+            {
+                table.swap(pool.back());
+                pool.pop_back();
+                pooledBytes -= table.capacity() * sizeof(Entry);
+            }
+        }
+        // a pooled buffer has the right capacity already, filling it needs no lock
+        table.assign(pow3(bagsize), value);
+        std::lock_guard<std::mutex> lock(mutex);
+        addLive(table.capacity() * sizeof(Entry));
+    }
+
+    // 'mutex' is held
+    void addLive(std::size_t bytes)
+    {
+        liveBytes += bytes;
+        peakBytes = std::max(peakBytes, liveBytes);
+        overallPeakBytes = std::max(overallPeakBytes, liveBytes);
+    }
+};
+
+inline Color colorAt(std::size_t index, std::size_t position)
+{
+    return static_cast<Color>((index / pow3(position)) % 3);
+}
+
+/**
+ * A single coloring as a value: 2 bits per position of the bag (the vertex order is the one of the bag), no heap and
+ * no interning. Tables never store colorings, this is for code that looks at several colors of one coloring, e.g. the
+ * reconstruction of a solution, instead of extracting one base-3 digit per division.
+ */
+class PackedColoring
+{
+public:
+    static constexpr std::size_t maxPositions = 32;
+
+    PackedColoring() = default;
+
+    // decodes the index of a coloring of a bag with 'bagsize' vertices
+    static PackedColoring fromIndex(std::size_t index, std::size_t bagsize)
+    {
+        assert(bagsize <= maxPositions && index < pow3(bagsize));
+        PackedColoring coloring;
+        for (std::size_t position = 0; position < bagsize; ++position, index /= 3)
+        {
+            coloring.bits |= static_cast<std::uint64_t>(index % 3) << (2 * position);
+        }
+        return coloring;
+    }
+
+    // index of this coloring in the table of a bag with 'bagsize' vertices
+    std::size_t index(std::size_t bagsize) const
+    {
+        std::size_t index = 0;
+        for (auto position = bagsize; position-- > 0;)
+        {
+            index = 3 * index + static_cast<std::size_t>((*this)[position]);
+        }
+        return index;
+    }
+
+    Color operator[](std::size_t position) const
+    {
+        return static_cast<Color>((bits >> (2 * position)) & 3);
+    }
+
+    void set(std::size_t position, Color color)
+    {
+        bits = (bits & ~(std::uint64_t{3} << (2 * position))) | (static_cast<std::uint64_t>(color) << (2 * position));
+    }
+
+    // the coloring of the bag with a vertex inserted at 'position' (the positions above move up by one)
+    PackedColoring inserted(std::size_t position, Color color) const
+    {
+        const auto lowMask = (std::uint64_t{1} << (2 * position)) - 1;
+        PackedColoring coloring;
+        coloring.bits = (bits & lowMask) | (static_cast<std::uint64_t>(color) << (2 * position)) |
+            ((bits & ~lowMask) << 2);
+        return coloring;
+    }
+
+    // the coloring of the bag with the vertex at 'position' removed
+    PackedColoring erased(std::size_t position) const
+    {
+        const auto lowMask = (std::uint64_t{1} << (2 * position)) - 1;
+        PackedColoring coloring;
+        coloring.bits = (bits & lowMask) | ((bits >> 2) & ~lowMask);
+        return coloring;
+    }
+
+    bool operator==(const PackedColoring& other) const
+    {
+        return bits == other.bits;
+    }
+
+private:
+    std::uint64_t bits = 0;
+};
+
+/************************************************************************************************************************/
+/* Splitting the work of one bag across threads */
+
+// tables with less entries are processed by a single thread, starting threads costs more than it saves
+constexpr std::size_t parallelThreshold = 59049; // 3^10
+
+/**
+ * Threads that exist already and may run the tasks of parallelFor on the calling thread, instead of new ones: called
+ * with the number of extra threads and the work, it runs the work on the caller and on up to that many of its threads
+ * and returns once all are done (as TreeScheduler::helpWith with its idle workers).
+ */
+using Helpers = std::function<void(std::size_t, const std::function<void()>&)>;
+
+// the helpers of the calling thread, none by default
+inline const Helpers*& threadHelpers()
+{
+    thread_local const Helpers* helpers = nullptr;
+    return helpers;
+}
+
+// installs 'helpers' for the calling thread while it lives
+class ScopedHelpers
+{
+public:
+    explicit ScopedHelpers(const Helpers* helpers) : previous(threadHelpers())
+    {
+        threadHelpers() = helpers;
+    }
+
+    ScopedHelpers(const ScopedHelpers&) = delete;
+    ScopedHelpers& operator=(const ScopedHelpers&) = delete;
+
+    ~ScopedHelpers()
+    {
+        threadHelpers() = previous;
+    }
+
+private:
+    const Helpers* previous;
+};
+
+/**
+ * Calls 'body(task)' for every task in [0, taskCount) on up to 'threads' threads, tasks are handed out dynamically.
+ * The extra threads are the helpers of the calling thread if it has some (see threadHelpers), new ones otherwise.
+ */
+template<typename Body>
+void parallelFor(std::size_t taskCount, std::size_t threads, const Body& body)
+{
+    threads = std::min(threads, taskCount);
+    if (threads <= 1)
+    {
+        for (std::size_t task = 0; task < taskCount; ++task)
+        {
+            body(task);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> nextTask = 0;
+    auto work = [&]()
+    {
+        for (auto task = nextTask++; task < taskCount; task = nextTask++)
+        {
+            body(task);
+        }
+    };
+    if (threadHelpers() != nullptr)
+    {
+        (*threadHelpers())(threads - 1, work);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i)
+    {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Views [0, count) as rows of length 'low' (the digits below a position) and calls 'body(hi, loBegin, loEnd)' for every
+ * contiguous row segment, split into chunks across threads if the range is large enough.
+ */
+template<typename Body>
+void forEachRow(std::size_t count, std::size_t low, std::size_t threads, const Body& body)
+{
+    const auto chunks = (threads > 1 && 3 * count >= parallelThreshold) ? 4 * threads : 1;
+    const auto chunkSize = (count + chunks - 1) / chunks;
+    parallelFor(chunks, threads, [&](std::size_t chunk)
+    {
+        const auto begin = std::min(count, chunk * chunkSize);
+        const auto end = std::min(count, begin + chunkSize);
+        for (auto index = begin; index < end;)
+        {
+            const auto hi = index / low;
+            const auto lo = index % low;
+            const auto loEnd = std::min(low, lo + (end - index));
+            body(hi, lo, loEnd);
+            index += loEnd - lo;
+        }
+    });
+}
+
+/************************************************************************************************************************/
+/* Kernels, the inner loops are branch-free so the compiler vectorizes them (compile with -march=native) */
+
+namespace detail
+{
+
+// c1+c2-cost of the compatible set (the black vertices of the bag are counted in both children), we treat max() as
+// infinity so overflow checks work a bit differently
+// (the result of finite values is a partial solution, so it fits into Value even if c1+c2 does not)
+template<typename Value>
+Value joinValue(Value value1, Value value2, std::uint32_t compatibleSetCost)
+{
+    return (value1 == infinity<Value> || value2 == infinity<Value>) ? infinity<Value> :
+        static_cast<Value>(value1 + value2 - compatibleSetCost);
+}
+
+#if defined(__AVX512F__)
+/**
+ * AVX-512 version of the two lowest digits of a join: the 16 consistent pairs of two digits are the 16 lanes of one
+ * vector. The 9 entries of both child blocks are loaded once and permuted into the lanes, then every parent entry
+ * takes the min over the lanes of its (1, 2 or 4) consistent pairs. Infinity is handled with masks instead of branches,
+ * the costs of both digits are added to the lanes where they are black.
+ * Narrow values are widened to 32 bit lanes when loaded and truncated when stored, which needs AVX-512BW/VL.
+ */
+struct JoinLanes
+{
+    std::array<int, 16> child1{};
+    std::array<int, 16> child2{};
+    // lanes where the lowest (black0) or the second digit (black1) of the parent is black
+    std::uint16_t black0 = 0;
+    std::uint16_t black1 = 0;
+    // for every parent entry the lanes of its consistent pairs, repeated if there are less than 4
+    std::array<std::array<int, 16>, 4> contributions{};
+};
+
+constexpr JoinLanes joinLanes = []()
+{
+    JoinLanes lanes;
+    std::array<int, 9> contributionCount{};
+    for (std::size_t t1 = 0; t1 < 4; ++t1)
+    {
+        for (std::size_t t0 = 0; t0 < 4; ++t0)
+        {
+            const auto lane = static_cast<int>(4 * t1 + t0);
+            const auto [p0, a0, b0] = consistentColorsArr[t0];
+            const auto [p1, a1, b1] = consistentColorsArr[t1];
+            const auto parent = static_cast<int>(p0) + 3 * static_cast<int>(p1);
+            lanes.child1[lane] = static_cast<int>(a0) + 3 * static_cast<int>(a1);
+            lanes.child2[lane] = static_cast<int>(b0) + 3 * static_cast<int>(b1);
+            lanes.black0 |= (p0 == Color::Black) ? 1 << lane : 0;
+            lanes.black1 |= (p1 == Color::Black) ? 1 << lane : 0;
+            lanes.contributions[contributionCount[parent]++][parent] = lane;
+        }
+    }
+    for (std::size_t parent = 0; parent < 9; ++parent)
+    {
+        for (auto j = contributionCount[parent]; j < 4; ++j)
+        {
+            lanes.contributions[j][parent] = lanes.contributions[j % contributionCount[parent]][parent];
+        }
+    }
+    return lanes;
+}();
+
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+template<typename Value>
+constexpr bool hasJoinLanes = true;
+#else
+template<typename Value>
+constexpr bool hasJoinLanes = sizeof(Value) == 4;
+#endif
+
+template<typename Value>
+__m512i loadLanes(__mmask16 mask, const Value * const values)
+{
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+    if constexpr (sizeof(Value) == 1)
+    {
+        return _mm512_cvtepu8_epi32(_mm_maskz_loadu_epi8(mask, values));
+    }
+    else if constexpr (sizeof(Value) == 2)
+    {
+        return _mm512_cvtepu16_epi32(_mm256_maskz_loadu_epi16(mask, values));
+    }
+#endif
+    static_assert(hasJoinLanes<Value>);
+    return _mm512_maskz_loadu_epi32(mask, values);
+}
+
+template<typename Value>
+void storeLanes(Value * const values, __mmask16 mask, __m512i lanes)
+{
+    if constexpr (sizeof(Value) == 1)
+    {
+        _mm512_mask_cvtepi32_storeu_epi8(values, mask, lanes);
+    }
+    else if constexpr (sizeof(Value) == 2)
+    {
+        _mm512_mask_cvtepi32_storeu_epi16(values, mask, lanes);
+    }
+    else
+    {
+        _mm512_mask_storeu_epi32(values, mask, lanes);
+    }
+}
+
+template<typename Value, typename Cost>
+void joinTwoDigits(Value * const table, const Value * const childTable1, const Value * const childTable2,
+    std::uint32_t compatibleSetCost, const Cost& cost)
+{
+    static_assert(sizeof(Value) <= sizeof(std::uint32_t));
+    constexpr __mmask16 block = 0x1ff; // 9 entries
+    const auto inf = _mm512_set1_epi32(static_cast<int>(infinity<Value>));
+
+    const auto block1 = loadLanes(block, childTable1);
+    const auto block2 = loadLanes(block, childTable2);
+    const auto value1 = _mm512_permutexvar_epi32(_mm512_loadu_si512(joinLanes.child1.data()), block1);
+    const auto value2 = _mm512_permutexvar_epi32(_mm512_loadu_si512(joinLanes.child2.data()), block2);
+    const auto infinite = _mm512_cmpeq_epi32_mask(value1, inf) | _mm512_cmpeq_epi32_mask(value2, inf);
+    auto costs = _mm512_set1_epi32(static_cast<int>(compatibleSetCost));
+    costs = _mm512_mask_add_epi32(costs, joinLanes.black0, costs, _mm512_set1_epi32(static_cast<int>(cost[0])));
+    costs = _mm512_mask_add_epi32(costs, joinLanes.black1, costs, _mm512_set1_epi32(static_cast<int>(cost[1])));
+    const auto values = _mm512_mask_blend_epi32(infinite,
+        _mm512_sub_epi32(_mm512_add_epi32(value1, value2), costs), inf);
+
+    auto result = _mm512_permutexvar_epi32(_mm512_loadu_si512(joinLanes.contributions[0].data()), values);
+    // unsigned min, infinity of uint32 is negative as a signed lane
+    for (std::size_t j = 1; j < 4; ++j)
+    {
+        result = _mm512_min_epu32(result,
+            _mm512_permutexvar_epi32(_mm512_loadu_si512(joinLanes.contributions[j].data()), values));
+    }
+    storeLanes(table, block, _mm512_min_epu32(result, loadLanes(block, table)));
+}
+#endif
+
+/**
+ * Joins the sub-tables spanned by the lowest 'digits' digits, starting at the given offsets of the three tables.
+ * The highest of these digits is fixed to every consistent triple (see consistentColorsArr), which again leaves three
+ * contiguous sub-tables. Nothing is materialized, the recursion walks the 4^digits triples in memory order.
+ * 'compatibleSetCost' is the cost of the black digits above.
+ */
+template<typename Value, typename Cost>
+void joinDigits(Value * const table, const Value * const childTable1, const Value * const childTable2,
+    std::size_t digits, std::uint32_t compatibleSetCost, const Cost& cost)
+{
+    constexpr auto white = static_cast<std::size_t>(Color::White);
+    constexpr auto black = static_cast<std::size_t>(Color::Black);
+    constexpr auto grey = static_cast<std::size_t>(Color::Grey);
+#if defined(__AVX512F__)
+    if constexpr (hasJoinLanes<Value>)
+    {
+        if (digits == 2)
+        {
+            joinTwoDigits(table, childTable1, childTable2, compatibleSetCost, cost);
+            return;
+        }
+    }
+#endif
+    if (digits == 1)
+    {
+        // the consistent triples of the lowest digit written out, so the recursion stops one level early
+        table[black] = std::min(table[black], joinValue(childTable1[black], childTable2[black], compatibleSetCost + cost[0]));
+        table[white] = std::min(table[white], std::min(
+            joinValue(childTable1[white], childTable2[grey], compatibleSetCost),
+            joinValue(childTable1[grey], childTable2[white], compatibleSetCost)
+        ));
+        table[grey] = std::min(table[grey], joinValue(childTable1[grey], childTable2[grey], compatibleSetCost));
+        return;
+    }
+    const auto weight = pow3(digits - 1);
+    for (const auto &[color, color1, color2] : consistentColorsArr)
+    {
+        joinDigits(
+            table + static_cast<std::size_t>(color) * weight,
+            childTable1 + static_cast<std::size_t>(color1) * weight,
+            childTable2 + static_cast<std::size_t>(color2) * weight,
+            digits - 1,
+            compatibleSetCost + (color == Color::Black ? cost[digits - 1] : 0),
+            cost
+        );
+    }
+}
+
+/**
+ * joinDigits which additionally records the consistent pair every parent entry took in 'choices' (see JoinChoices),
+ * 'whiteInChild1' holds the bits of the digits above. Only used to reconstruct solutions, so it stays scalar.
+ */
+template<typename Value, typename Cost>
+void joinDigitsWithChoices(Value * const table, const Value * const childTable1, const Value * const childTable2,
+    std::uint32_t * const choices, std::size_t digits, std::uint32_t compatibleSetCost, std::uint32_t whiteInChild1,
+    const Cost& cost)
+{
+    if (digits == 0)
+    {
+        const auto value = joinValue(childTable1[0], childTable2[0], compatibleSetCost);
+        if (value < table[0])
+        {
+            table[0] = value;
+            choices[0] = whiteInChild1;
+        }
+        return;
+    }
+    const auto weight = pow3(digits - 1);
+    for (const auto &[color, color1, color2] : consistentColorsArr)
+    {
+        const auto bit = (color == Color::White && color1 == Color::White) ? std::uint32_t{1} << (digits - 1) : 0;
+        joinDigitsWithChoices(
+            table + static_cast<std::size_t>(color) * weight,
+            childTable1 + static_cast<std::size_t>(color1) * weight,
+            childTable2 + static_cast<std::size_t>(color2) * weight,
+            choices + static_cast<std::size_t>(color) * weight,
+            digits - 1,
+            compatibleSetCost + (color == Color::Black ? cost[digits - 1] : 0),
+            whiteInChild1 | bit,
+            cost
+        );
+    }
+}
+
+} // namespace detail
+
+
+/**
+ * Kernels for bags with up to small::maxBagSize vertices, instantiated for every bag size and position (pair of
+ * positions for edges), so all table sizes and digit weights are compile-time constants: the loops have constant
+ * trip counts, the compiler unrolls and vectorizes them, and no index is divided at runtime. Every kernel call costs
+ * a single lookup in the tables below, larger bags (and bags that are split across threads) use the generic kernels.
+ */
+namespace small
+{
+
+constexpr std::size_t maxBagSize = 9;
+
+template<typename Value, typename Cost>
+using IntroduceKernel = void (*)(Value * const, const Value * const, const Cost&);
+template<typename Value>
+using ForgetKernel = void (*)(Value * const, const Value * const);
+template<typename Value, typename Cost>
+using JoinKernel = void (*)(Value * const, const Value * const, const Value * const, const Cost&);
+template<typename Value>
+using EdgeKernel = void (*)(Value * const);
+
+// 'BagSize' is the size of the bag of 'table', the vertex is introduced at 'Position'
+template<typename Value, typename Cost, std::size_t BagSize, std::size_t Position>
+void introduceVertex(Value * const table, const Value * const childTable, const Cost& cost)
+{
+    constexpr auto low = pow3Arr[Position];
+    constexpr auto high = pow3Arr[BagSize - 1 - Position];
+    const auto blackCost = static_cast<Value>(cost[Position]);
+    for (std::size_t hi = 0; hi < high; ++hi)
+    {
+        const auto child = childTable + hi * low;
+        const auto white = table + hi * 3 * low + static_cast<std::size_t>(Color::White) * low;
+        const auto black = table + hi * 3 * low + static_cast<std::size_t>(Color::Black) * low;
+        const auto grey = table + hi * 3 * low + static_cast<std::size_t>(Color::Grey) * low;
+        for (std::size_t lo = 0; lo < low; ++lo)
+        {
+            const auto childValue = child[lo];
+            white[lo] = infinity<Value>;
+            black[lo] = childValue + (childValue != infinity<Value>) * blackCost;
+            grey[lo] = childValue;
+        }
+    }
+}
+
+// 'BagSize' is the size of the bag of 'table', the vertex at 'Position' of the child bag is forgotten
+template<typename Value, std::size_t BagSize, std::size_t Position>
+void forgetVertex(Value * const table, const Value * const childTable)
+{
+    constexpr auto low = pow3Arr[Position];
+    constexpr auto high = pow3Arr[BagSize - Position];
+    for (std::size_t hi = 0; hi < high; ++hi)
+    {
+        const auto parent = table + hi * low;
+        const auto white = childTable + hi * 3 * low + static_cast<std::size_t>(Color::White) * low;
+        const auto black = childTable + hi * 3 * low + static_cast<std::size_t>(Color::Black) * low;
+        for (std::size_t lo = 0; lo < low; ++lo)
+        {
+            parent[lo] = std::min(white[lo], black[lo]);
+        }
+    }
+}
+
+// detail::joinDigits with the number of digits as template parameter, the recursion is resolved at compile time
+template<typename Value, typename Cost, std::size_t Digits>
+void joinDigits(Value * const table, const Value * const childTable1, const Value * const childTable2,
+    std::uint32_t compatibleSetCost, const Cost& cost)
+{
+    constexpr auto white = static_cast<std::size_t>(Color::White);
+    constexpr auto black = static_cast<std::size_t>(Color::Black);
+    constexpr auto grey = static_cast<std::size_t>(Color::Grey);
+#if defined(__AVX512F__)
+    if constexpr (Digits == 2 && detail::hasJoinLanes<Value>)
+    {
+        detail::joinTwoDigits(table, childTable1, childTable2, compatibleSetCost, cost);
+        return;
+    }
+#endif
+    if constexpr (Digits == 1)
+    {
+        table[black] = std::min(table[black], detail::joinValue(childTable1[black], childTable2[black], compatibleSetCost + cost[0]));
+        table[white] = std::min(table[white], std::min(
+            detail::joinValue(childTable1[white], childTable2[grey], compatibleSetCost),
+            detail::joinValue(childTable1[grey], childTable2[white], compatibleSetCost)
+        ));
+        table[grey] = std::min(table[grey], detail::joinValue(childTable1[grey], childTable2[grey], compatibleSetCost));
+    }
+    else
+    {
+        constexpr auto weight = pow3Arr[Digits - 1];
+        for (const auto &[color, color1, color2] : consistentColorsArr)
+        {
+            joinDigits<Value, Cost, Digits - 1>(
+                table + static_cast<std::size_t>(color) * weight,
+                childTable1 + static_cast<std::size_t>(color1) * weight,
+                childTable2 + static_cast<std::size_t>(color2) * weight,
+                compatibleSetCost + (color == Color::Black ? cost[Digits - 1] : 0),
+                cost
+            );
+        }
+    }
+}
+
+template<typename Value, typename Cost, std::size_t BagSize>
+void join(Value * const table, const Value * const childTable1, const Value * const childTable2, const Cost& cost)
+{
+    joinDigits<Value, Cost, BagSize>(table, childTable1, childTable2, 0, cost);
+}
+
+/**
+ * The edge between the positions 'Low' < 'High': the digits split an index into hi (above High), mid (between both)
+ * and lo (below Low), and the white/black colorings of every (hi, mid) block read the grey/black ones of the same block.
+ */
+template<typename Value, std::size_t BagSize, std::size_t Low, std::size_t High>
+void introduceEdge(Value * const table)
+{
+    constexpr auto lowWeight = pow3Arr[Low];
+    constexpr auto highWeight = pow3Arr[High];
+    constexpr auto white = static_cast<std::size_t>(Color::White);
+    constexpr auto black = static_cast<std::size_t>(Color::Black);
+    constexpr auto grey = static_cast<std::size_t>(Color::Grey);
+    for (std::size_t hi = 0; hi < pow3Arr[BagSize - 1 - High]; ++hi)
+    {
+        for (std::size_t mid = 0; mid < pow3Arr[High - Low - 1]; ++mid)
+        {
+            const auto block = table + hi * 3 * highWeight + mid * 3 * lowWeight;
+            for (std::size_t lo = 0; lo < lowWeight; ++lo)
+            {
+                block[black * lowWeight + white * highWeight + lo] = block[black * lowWeight + grey * highWeight + lo];
+                block[white * lowWeight + black * highWeight + lo] = block[grey * lowWeight + black * highWeight + lo];
+            }
+        }
+    }
+}
+
+/* Dispatch tables, indexed by the bag size of 'table' and the position(s), entries of impossible positions are null */
+template<typename Value, typename Cost, std::size_t BagSize, std::size_t... Positions>
+constexpr std::array<IntroduceKernel<Value, Cost>, maxBagSize> introduceKernelsOf(std::index_sequence<Positions...>)
+{
+    return { { &introduceVertex<Value, Cost, BagSize, Positions>... } };
+}
+
+template<typename Value, typename Cost, std::size_t... BagSizes>
+constexpr std::array<std::array<IntroduceKernel<Value, Cost>, maxBagSize>, maxBagSize + 1> introduceKernelTable(
+    std::index_sequence<BagSizes...>)
+{
+    return { { introduceKernelsOf<Value, Cost, BagSizes>(std::make_index_sequence<BagSizes>())... } };
+}
+
+template<typename Value, std::size_t BagSize, std::size_t... Positions>
+constexpr std::array<ForgetKernel<Value>, maxBagSize> forgetKernelsOf(std::index_sequence<Positions...>)
+{
+    return { { &forgetVertex<Value, BagSize, Positions>... } };
+}
+
+// the child of a forget bag has one vertex more, so the bag has at most maxBagSize - 1
+template<typename Value, std::size_t... BagSizes>
+constexpr std::array<std::array<ForgetKernel<Value>, maxBagSize>, maxBagSize> forgetKernelTable(
+    std::index_sequence<BagSizes...>)
+{
+    return { { forgetKernelsOf<Value, BagSizes>(std::make_index_sequence<BagSizes + 1>())... } };
+}
+
+template<typename Value, typename Cost, std::size_t... BagSizes>
+constexpr std::array<JoinKernel<Value, Cost>, maxBagSize + 1> joinKernelTable(std::index_sequence<BagSizes...>)
+{
+    return { { nullptr, &join<Value, Cost, BagSizes + 1>... } };
+}
+
+template<typename Value, std::size_t BagSize, std::size_t High, std::size_t... Lows>
+constexpr std::array<EdgeKernel<Value>, maxBagSize> edgeKernelsBelow(std::index_sequence<Lows...>)
+{
+    return { { &introduceEdge<Value, BagSize, Lows, High>... } };
+}
+
+template<typename Value, std::size_t BagSize, std::size_t... Highs>
+constexpr std::array<std::array<EdgeKernel<Value>, maxBagSize>, maxBagSize> edgeKernelsOf(std::index_sequence<Highs...>)
+{
+    return { { edgeKernelsBelow<Value, BagSize, Highs>(std::make_index_sequence<Highs>())... } };
+}
+
+template<typename Value, std::size_t... BagSizes>
+constexpr std::array<std::array<std::array<EdgeKernel<Value>, maxBagSize>, maxBagSize>, maxBagSize + 1> edgeKernelTable(
+    std::index_sequence<BagSizes...>)
+{
+    return { { edgeKernelsOf<Value, BagSizes>(std::make_index_sequence<BagSizes>())... } };
+}
+
+// the introduce and join kernels of a cost policy are only instantiated if it is used
+template<typename Value, typename Cost>
+constexpr auto introduceKernels = introduceKernelTable<Value, Cost>(std::make_index_sequence<maxBagSize + 1>());
+template<typename Value>
+constexpr auto forgetKernels = forgetKernelTable<Value>(std::make_index_sequence<maxBagSize>());
+template<typename Value, typename Cost>
+constexpr auto joinKernels = joinKernelTable<Value, Cost>(std::make_index_sequence<maxBagSize>());
+// indexed by [bag size][higher position][lower position]
+template<typename Value>
+constexpr auto edgeKernels = edgeKernelTable<Value>(std::make_index_sequence<maxBagSize + 1>());
+
+// bag size of a dense table
+inline std::size_t bagSizeOf(std::size_t tableSize)
+{
+    std::size_t bagsize = 0;
+    while (pow3Arr[bagsize] < tableSize)
+    {
+        ++bagsize;
+    }
+    assert(pow3Arr[bagsize] == tableSize);
+    return bagsize;
+}
+
+// whether the kernels of a bag (its largest table having 'largestTableSize' entries) are covered here; the generic ones
+// split tables of this size across threads
+inline bool covers(std::size_t largestTableSize, std::size_t threads)
+{
+    return largestTableSize <= pow3Arr[maxBagSize] && (threads <= 1 || 3 * largestTableSize < parallelThreshold);
+}
+
+} // namespace small
+
+/**
+ * Introduces the vertex at 'position' of the bag. The table of the child is the table of the bag without this digit.
+ * A black vertex adds its cost (see UnitCost).
+ */
+template<typename Value, typename Cost = UnitCost>
+void introduceVertex(Table<Value>& table, const Table<Value>& childTable, std::size_t position, std::size_t threads = 1,
+    const Cost& cost = {})
+{
+    assert(table.size() == 3 * childTable.size());
+    if (small::covers(table.size(), threads))
+    {
+        small::introduceKernels<Value, Cost>[small::bagSizeOf(table.size())][position](table.data(), childTable.data(),
+            cost);
+        return;
+    }
+    const auto low = pow3(position);
+    const auto blackCost = static_cast<Value>(cost[position]);
+
+    forEachRow(childTable.size(), low, threads, [&](std::size_t hi, std::size_t loBegin, std::size_t loEnd)
+    {
+        const auto child = childTable.data() + hi * low;
+        const auto white = table.data() + hi * 3 * low + static_cast<std::size_t>(Color::White) * low;
+        const auto black = table.data() + hi * 3 * low + static_cast<std::size_t>(Color::Black) * low;
+        const auto grey = table.data() + hi * 3 * low + static_cast<std::size_t>(Color::Grey) * low;
+        for (auto lo = loBegin; lo < loEnd; ++lo)
+        {
+            const auto childValue = child[lo];
+            // a new white vertex can not be dominated yet, since its edges are introduced later
+            white[lo] = infinity<Value>;
+            // saturating +cost: infinity stays infinity
+            black[lo] = childValue + (childValue != infinity<Value>) * blackCost;
+            grey[lo] = childValue;
+        }
+    });
+}
+
+/**
+ * An introduced vertex at 'position' that is dominated already (by a vertex outside of the graph, see
+ * minDominatingSet) does not need a black neighbor: its white colorings take the values of the grey ones. Edges and
+ * joins keep both equal, so this is only applied once after the introduce.
+ */
+template<typename Value>
+void dominateVertex(Table<Value>& table, std::size_t position, std::size_t threads = 1)
+{
+    const auto low = pow3(position);
+    forEachRow(table.size() / 3, low, threads, [&](std::size_t hi, std::size_t loBegin, std::size_t loEnd)
+    {
+        const auto white = table.data() + hi * 3 * low + static_cast<std::size_t>(Color::White) * low;
+        const auto grey = table.data() + hi * 3 * low + static_cast<std::size_t>(Color::Grey) * low;
+        std::copy(grey + loBegin, grey + loEnd, white + loBegin);
+    });
+}
+
+/**
+ * Forgets the vertex at 'position' of the child bag. A forgotten vertex must either be in the solution or dominated.
+ * If 'choices' is given, it records which of both colorings was taken.
+ */
+template<typename Value>
+void forgetVertex(Table<Value>& table, const Table<Value>& childTable, std::size_t position, std::size_t threads = 1,
+    ForgetChoices* const choices = nullptr)
+{
+    assert(3 * table.size() == childTable.size());
+    if (choices == nullptr && small::covers(childTable.size(), threads))
+    {
+        small::forgetKernels<Value>[small::bagSizeOf(table.size())][position](table.data(), childTable.data());
+        return;
+    }
+    const auto low = pow3(position);
+
+    forEachRow(table.size(), low, threads, [&](std::size_t hi, std::size_t loBegin, std::size_t loEnd)
+    {
+        const auto parent = table.data() + hi * low;
+        const auto white = childTable.data() + hi * 3 * low + static_cast<std::size_t>(Color::White) * low;
+        const auto black = childTable.data() + hi * 3 * low + static_cast<std::size_t>(Color::Black) * low;
+        for (auto lo = loBegin; lo < loEnd; ++lo)
+        {
+            parent[lo] = std::min(white[lo], black[lo]);
+        }
+        if (choices != nullptr)
+        {
+            const auto choice = choices->data() + hi * low;
+            for (auto lo = loBegin; lo < loEnd; ++lo)
+            {
+                choice[lo] = black[lo] < white[lo];
+            }
+        }
+    });
+}
+
+/**
+ * Combines the tables of both children of a join bag: every coloring takes the min over its consistent
+ * pairs of child colorings, which are enumerated on the fly without storing anything per bag.
+ * For large tables the colorings of the highest digits are split into tasks, each task owns a disjoint
+ * slice of the table. If 'choices' is given, it records the pair of child colorings every entry took.
+ * The black vertices of the bag are counted in both children, their cost is subtracted once.
+ */
+template<typename Value, typename Cost = UnitCost>
+void join(Table<Value>& table, const Table<Value>& childTable1, const Table<Value>& childTable2, std::size_t bagsize,
+    std::size_t threads = 1, JoinChoices* const choices = nullptr, const Cost& cost = {})
+{
+    assert(table.size() == pow3(bagsize));
+    assert(childTable1.size() == table.size() && childTable2.size() == table.size());
+    std::fill(table.begin(), table.end(), infinity<Value>);
+    if (bagsize == 0)
+    {
+        table.front() = detail::joinValue(childTable1.front(), childTable2.front(), 0);
+        return;
+    }
+    if (choices == nullptr && small::covers(table.size(), threads))
+    {
+        small::joinKernels<Value, Cost>[bagsize](table.data(), childTable1.data(), childTable2.data(), cost);
+        return;
+    }
+
+    // 3^3 slices are plenty to balance the load, their cost differs by the number of white digits (2^white)
+    const std::size_t splitDigits = (threads > 1 && table.size() >= parallelThreshold) ? std::min<std::size_t>(3, bagsize - 1) : 0;
+    const auto lowDigits = bagsize - splitDigits;
+    const auto weight = pow3(lowDigits);
+    parallelFor(pow3(splitDigits), threads, [&](std::size_t slice)
+    {
+        // enumerate all consistent child colorings of the split digits of this slice,
+        // every white digit is either white in the first or in the second child
+        const auto sliceColoring = PackedColoring::fromIndex(slice, splitDigits);
+        std::uint32_t blackCost = 0;
+        std::size_t whiteCount = 0;
+        for (std::size_t digit = 0; digit < splitDigits; ++digit)
+        {
+            blackCost += sliceColoring[digit] == Color::Black ? cost[lowDigits + digit] : 0;
+            whiteCount += sliceColoring[digit] == Color::White;
+        }
+        for (std::size_t choice = 0; choice < (std::size_t{1} << whiteCount); ++choice)
+        {
+            std::size_t slice1 = slice;
+            std::size_t slice2 = slice;
+            std::uint32_t whiteInChild1 = 0;
+            std::size_t whiteDigit = 0;
+            for (std::size_t digit = 0; digit < splitDigits; ++digit)
+            {
+                if (sliceColoring[digit] == Color::White)
+                {
+                    constexpr auto whiteToGrey = static_cast<std::size_t>(Color::Grey) - static_cast<std::size_t>(Color::White);
+                    const auto greyInChild1 = (choice >> whiteDigit++) & 1;
+                    (greyInChild1 ? slice1 : slice2) += whiteToGrey * pow3(digit);
+                    whiteInChild1 |= greyInChild1 ? 0 : std::uint32_t{1} << (lowDigits + digit);
+                }
+            }
+            if (choices != nullptr)
+            {
+                detail::joinDigitsWithChoices(table.data() + slice * weight, childTable1.data() + slice1 * weight,
+                    childTable2.data() + slice2 * weight, choices->data() + slice * weight, lowDigits, blackCost,
+                    whiteInChild1, cost);
+            }
+            else
+            {
+                detail::joinDigits(table.data() + slice * weight, childTable1.data() + slice1 * weight,
+                    childTable2.data() + slice2 * weight, lowDigits, blackCost, cost);
+            }
+        }
+    });
+}
+
+namespace detail
+{
+
+// mask of the white digits of (part of) an index, and of all positions with an edge to a black digit
+struct EdgeDigits
+{
+    std::uint32_t white = 0;
+    std::uint32_t covered = 0;
+};
+
+// the 'digits' digits of 'index' as the positions [offset, offset + digits) of the bag
+inline EdgeDigits edgeDigitsOf(std::size_t index, std::size_t digits, std::size_t offset,
+    const std::array<std::uint32_t, maxBagSize>& adjacent)
+{
+    EdgeDigits result;
+    for (auto position = offset; position < offset + digits; ++position, index /= 3)
+    {
+        const auto color = static_cast<Color>(index % 3);
+        if (color == Color::Black)
+        {
+            result.covered |= adjacent[position];
+        }
+        else if (color == Color::White)
+        {
+            result.white |= std::uint32_t{ 1 } << position;
+        }
+    }
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * Introduces all edges of a bag (pairs of positions) at once. The effects of the edges compose: a coloring takes the
+ * value of the coloring where every white vertex with a black neighbor along one of the new edges is grey (this one
+ * has no such vertex, so it is not changed itself and the table is updated in place). Small tables apply the
+ * specialized kernel of every edge, larger ones need a single pass for all edges: the colors of the lowest digits are
+ * looked up, the higher ones decoded once per row.
+ */
+template<typename Value>
+void introduceEdges(Table<Value>& table, const std::vector<std::pair<std::size_t, std::size_t>>& edges,
+    std::size_t threads = 1)
+{
+    if (edges.empty())
+    {
+        return;
+    }
+    if (small::covers(table.size(), threads))
+    {
+        for (const auto &[u, v] : edges)
+        {
+            small::edgeKernels<Value>[small::bagSizeOf(table.size())][std::max(u, v)][std::min(u, v)](table.data());
+        }
+        return;
+    }
+    std::size_t bagsize = 0;
+    while (pow3(bagsize) < table.size())
+    {
+        ++bagsize;
+    }
+    std::array<std::uint32_t, maxBagSize> adjacent{};
+    for (const auto &[u, v] : edges)
+    {
+        adjacent[u] |= std::uint32_t{ 1 } << v;
+        adjacent[v] |= std::uint32_t{ 1 } << u;
+    }
+    constexpr auto whiteToGrey = static_cast<std::size_t>(Color::Grey) - static_cast<std::size_t>(Color::White);
+    const auto lowDigits = std::min<std::size_t>(bagsize, 6);
+    const auto low = pow3(lowDigits);
+    std::vector<detail::EdgeDigits> lows(low);
+    for (std::size_t lo = 0; lo < low; ++lo)
+    {
+        lows[lo] = detail::edgeDigitsOf(lo, lowDigits, 0, adjacent);
+    }
+
+    forEachRow(table.size(), low, threads, [&](std::size_t hi, std::size_t loBegin, std::size_t loEnd)
+    {
+        const auto high = detail::edgeDigitsOf(hi, bagsize - lowDigits, lowDigits, adjacent);
+        const auto row = table.data() + hi * low;
+        for (auto lo = loBegin; lo < loEnd; ++lo)
+        {
+            auto dominated = (high.white | lows[lo].white) & (high.covered | lows[lo].covered);
+            if (dominated == 0)
+            {
+                continue;
+            }
+            std::size_t offset = 0;
+            for (; dominated != 0; dominated &= dominated - 1)
+            {
+                offset += whiteToGrey * pow3Arr[__builtin_ctz(dominated)];
+            }
+            row[lo] = row[lo + offset];
+        }
+    });
+}
+
+/**
+ * Introduces the edge between the vertices at position u and v of the bag: a white vertex which has a black neighbor
+ * is dominated, so it takes the value of the same coloring where it is grey (not required to be dominated).
+ */
+template<typename Value>
+void introduceEdge(Table<Value>& table, std::size_t u, std::size_t v, std::size_t threads = 1)
+{
+    introduceEdges(table, { { u, v } }, threads);
+}
+
+// sets all entries above 'limit' to infinity, returns how many finite entries were pruned
+template<typename Value>
+std::size_t prune(Table<Value>& table, Value limit)
+{
+    std::size_t pruned = 0;
+    for (auto &value : table)
+    {
+        const auto prunable = value > limit && value != infinity<Value>;
+        pruned += prunable;
+        value = prunable ? infinity<Value> : value;
+    }
+    return pruned;
+}
+
+} // namespace indexed
@@ -0,0 +1,1352 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <assert.h>
+#include <unistd.h>
+
+#include "indexedTable.hpp"
+#include "sparseTable.hpp"
+#include "treeDecomposition.hpp"
+#include "treeScheduler.hpp"
+
+/**
+ * The min-dominating-set DP as a library: it takes a labelled nice-TD as in-memory arrays (see NiceBag) and returns
+ * the size of a minimum dominating set, or its weight for vertex weights (the kernels take the cost of black vertices
+ * as a policy, see indexed::UnitCost). Used by the executables and by the python module (pyMinDominatingSet.cpp).
+ */
+
+/************************************************************************************************************************/
+/* Definition of Data-Structured used in the algorithm */
+// storage (and kernels) of the state of a bag, chosen per bag (see detail::chooseEngine)
+enum class Engine : std::uint8_t
+{
+    Dense, Sparse
+};
+
+// index of a bag in its nice-TD, the root is 0
+using BagNumber = std::uint32_t;
+
+// 'Value' is the entry type of the tables (see indexed::infinity)
+template<typename Value>
+struct Bag
+{
+    BagNumber number;
+    BagType type;
+    std::optional<BagNumber> parentNumber;
+    // in digit order (the i-th vertex is the i-th digit of the index of a coloring in 'c'), sorted until makeBags
+    // derives it from the parent (see setDigitOrder)
+    std::vector<int> bagElements;
+    std::vector<std::pair<int, int>> introduceEdges;
+    std::optional<BagNumber> child1 = std::nullopt;
+    std::optional<BagNumber> child2 = std::nullopt;
+    // the kernels only see positions within the bag (digits of the table index), never vertex IDs: the positions of
+    // the endpoints of the introduce edges, and of the vertex an introduce bag adds (in this bag) or a forget bag and
+    // the root remove (in the child), see locateChangedVertex
+    std::vector<std::pair<std::size_t, std::size_t>> edgePositions;
+    std::size_t changedPosition = 0;
+    // with vertex weights the weights of 'bagElements' in bag order (only for the introduce and join bags, which add
+    // costs), empty for unit costs, see setWeights
+    std::vector<std::uint32_t> weights;
+    // an introduce bag whose vertex is dominated already (see minDominatingSet), its white colorings are finite
+    bool dominatedVertex = false;
+
+    // datastructure to map colorings (minimum compatible set) to values, indexed by the base-3 encoding of the coloring
+    // only allocated while the bag is processed and until its parent consumed it
+    // with the sparse engine 'sparseC' holds the finite entries instead
+    Engine engine = Engine::Dense;
+    indexed::Table<Value> c;
+    sparse::Table<Value> sparseC;
+    // backpointers of forget (and the root) or join bags, only recorded when a solution is reconstructed
+    indexed::ForgetChoices forgetChoices;
+    indexed::JoinChoices joinChoices;
+    // entries above this value cannot be part of a minimum dominating set and are pruned (see detail::pruneLimits)
+    Value pruneAbove = indexed::infinity<Value>;
+    // file holding the state while it waits on disk for its parent (see spillState), empty if it is in memory
+    std::string spillFile;
+    std::size_t spilledEntries = 0;
+
+    explicit Bag(BagNumber number, BagType type, std::optional<BagNumber> parentNumber,
+        std::vector<int> vertices, std::vector<std::pair<int, int>> edges) :
+        number(number), type(type), parentNumber(parentNumber), bagElements(std::move(vertices)),
+        introduceEdges(std::move(edges))
+    {
+        // only the root (reserved number 0) has not parent in a labelled TD
+        assert(number == 0 || parentNumber.has_value());
+        // root must be empty bag
+        assert(number != 0 || bagElements.size() == 0);
+        // introduce edges not possible on leaf-nodes
+        assert(introduceEdges.size() == 0 || type != BagType::Leaf);
+        assert(bagElements.size() <= indexed::maxBagSize);
+
+        std::sort(bagElements.begin(), bagElements.end());
+        setIntroduceEdges(std::move(introduceEdges));
+    }
+
+    // replaces the edges introduced at this bag, both endpoints have to be in the bag
+    void setIntroduceEdges(std::vector<std::pair<int, int>> edges)
+    {
+        introduceEdges = std::move(edges);
+        edgePositions.clear();
+        edgePositions.reserve(introduceEdges.size());
+        for (const auto &[u, v] : introduceEdges)
+        {
+            edgePositions.emplace_back(positionOf(u), positionOf(v));
+        }
+    }
+
+    // takes the weights of the bag vertices from 'vertexWeights' (indexed by vertex id) if this bag adds costs
+    void setWeights(const std::vector<std::uint32_t>& vertexWeights)
+    {
+        weights.clear();
+        if (parentNumber.has_value() && (type == BagType::Intro || type == BagType::Join))
+        {
+            for (const auto vertex : bagElements)
+            {
+                weights.push_back(vertexWeights[vertex]);
+            }
+        }
+    }
+
+    // replaces the digit order of the bag by 'order', a permutation of 'bagElements'
+    void setDigitOrder(std::vector<int> order)
+    {
+        assert(std::is_permutation(order.cbegin(), order.cend(), bagElements.cbegin(), bagElements.cend()));
+        bagElements = std::move(order);
+        setIntroduceEdges(std::move(introduceEdges));
+    }
+
+    // sets changedPosition, the bag and its child only differ in one vertex
+    void locateChangedVertex(const Bag& child)
+    {
+        const auto introduced = type == BagType::Intro && parentNumber.has_value();
+        const auto &larger = introduced ? bagElements : child.bagElements;
+        const auto &smaller = introduced ? child.bagElements : bagElements;
+        assert(larger.size() == smaller.size() + 1);
+        changedPosition = static_cast<std::size_t>(
+            std::mismatch(smaller.cbegin(), smaller.cend(), larger.cbegin()).second - larger.cbegin());
+    }
+
+    // fill search state for this bag, the empty coloring of a leaf is the only one with a known value
+    // sparse tables grow while they are filled and are accounted afterwards
+    void allocateState(indexed::TableMemory& memory)
+    {
+        if (engine == Engine::Dense)
+        {
+            memory.allocate(c, bagElements.size());
+        }
+        if (type == BagType::Leaf)
+        {
+            if (engine == Engine::Dense)
+            {
+                c.front() = 0;
+            }
+            else
+            {
+                sparseC.push(0, 0);
+            }
+        }
+    }
+
+    void releaseState(indexed::TableMemory& memory)
+    {
+        if (!spillFile.empty())
+        {
+            std::remove(spillFile.c_str());
+            spillFile.clear();
+        }
+        memory.release(c);
+        memory.release(sparseC.keys);
+        memory.release(sparseC.values);
+    }
+
+    /**
+     * Writes the state to 'path' as the raw entries (keys then values for sparse tables) and frees it, restoreState
+     * reads it back in one sequential pass. Returns the number of bytes written, 0 if the file could not be written, the
+     * state then stays in memory.
+     */
+    std::size_t spillState(const std::string& path, indexed::TableMemory& memory)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (engine == Engine::Dense)
+        {
+            out.write(reinterpret_cast<const char*>(c.data()), static_cast<std::streamsize>(c.size() * sizeof(Value)));
+        }
+        else
+        {
+            out.write(reinterpret_cast<const char*>(sparseC.keys.data()),
+                static_cast<std::streamsize>(sparseC.size() * sizeof(sparse::Key)));
+            out.write(reinterpret_cast<const char*>(sparseC.values.data()),
+                static_cast<std::streamsize>(sparseC.size() * sizeof(Value)));
+        }
+        out.close();
+        if (!out)
+        {
+            std::remove(path.c_str());
+            return 0;
+        }
+        spillFile = path;
+        spilledEntries = engine == Engine::Dense ? c.size() : sparseC.size();
+        memory.release(c);
+        memory.release(sparseC.keys);
+        memory.release(sparseC.values);
+        return spilledEntries * (sizeof(Value) + (engine == Engine::Sparse ? sizeof(sparse::Key) : 0));
+    }
+
+    // reads a spilled state back into memory and deletes its file, nothing to do if the state was not spilled
+    void restoreState(indexed::TableMemory& memory)
+    {
+        if (spillFile.empty())
+        {
+            return;
+        }
+        std::ifstream in(spillFile, std::ios::binary);
+        if (engine == Engine::Dense)
+        {
+            memory.allocate(c, bagElements.size());
+            in.read(reinterpret_cast<char*>(c.data()), static_cast<std::streamsize>(c.size() * sizeof(Value)));
+        }
+        else
+        {
+            sparseC.keys.resize(spilledEntries);
+            sparseC.values.resize(spilledEntries);
+            in.read(reinterpret_cast<char*>(sparseC.keys.data()),
+                static_cast<std::streamsize>(spilledEntries * sizeof(sparse::Key)));
+            in.read(reinterpret_cast<char*>(sparseC.values.data()),
+                static_cast<std::streamsize>(spilledEntries * sizeof(Value)));
+            memory.account(sparseC.bytes());
+        }
+        if (!in)
+        {
+            throw std::runtime_error("could not read the spilled table " + spillFile);
+        }
+        in.close();
+        std::remove(spillFile.c_str());
+        spillFile.clear();
+    }
+
+    // converts the state to the given engine, a parent reads the state of its children in its own engine
+    void convertState(Engine to, indexed::TableMemory& memory)
+    {
+        if (engine == to)
+        {
+            return;
+        }
+        if (to == Engine::Dense)
+        {
+            memory.allocate(c, bagElements.size());
+            sparse::toDense(c, sparseC);
+            memory.release(sparseC.keys);
+            memory.release(sparseC.values);
+        }
+        else
+        {
+            sparseC = sparse::fromDense(c);
+            memory.account(sparseC.bytes());
+            memory.release(c);
+        }
+        engine = to;
+    }
+
+    // entries of the state (the finite ones of a sparse table) and its bytes, without backpointers
+    std::size_t stateEntries() const
+    {
+        return engine == Engine::Dense ? c.size() : sparseC.size();
+    }
+
+    std::size_t stateBytes() const
+    {
+        return engine == Engine::Dense ? c.capacity() * sizeof(Value) : sparseC.bytes();
+    }
+
+    // fraction of finite entries, estimated from a sample of dense tables
+    double fill() const
+    {
+        const auto size = indexed::pow3(bagElements.size());
+        if (engine == Engine::Sparse)
+        {
+            return static_cast<double>(sparseC.size()) / size;
+        }
+        // the stride must not be a multiple of 3, otherwise the sample only sees some colors of the lowest digits
+        constexpr std::size_t samples = 4096;
+        auto stride = std::max<std::size_t>(1, size / samples);
+        stride += stride % 3 == 0;
+        std::size_t sampled = 0;
+        std::size_t finite = 0;
+        for (std::size_t index = 0; index < size; index += stride, ++sampled)
+        {
+            finite += c[index] != indexed::infinity<Value>;
+        }
+        return static_cast<double>(finite) / sampled;
+    }
+
+    bool operator==(const Bag& otherBag) const
+    {
+        return number == otherBag.number;
+    }
+
+    // position of a vertex within the bag, i.e. the digit of its color in the index of a coloring
+    std::size_t positionOf(int vertex) const
+    {
+        const auto it = std::find(bagElements.cbegin(), bagElements.cend(), vertex);
+        assert(it != bagElements.cend());
+        return static_cast<std::size_t>(it - bagElements.cbegin());
+    }
+
+    std::string toString() const
+    {
+        std::string ret = std::string("") + static_cast<char>(type) + std::string("-Bag ");
+        if (parentNumber.has_value())
+        {
+            ret += std::to_string(number) + std::string(" with parent: ")
+            + std::to_string(parentNumber.value()) + std::string(" and vertices: ");
+        }
+        else
+        {
+            ret += std::string("(Root) ") + std::to_string(number);
+            return ret;
+        }
+        for (auto i = 0; i < bagElements.size(); ++i)
+        {
+            ret += std::to_string(bagElements[i]);
+            if (i + 1 < bagElements.size())
+            {
+                ret += std::string(", ");
+            }
+        }
+        if (introduceEdges.size() > 0)
+        {
+            ret += "; Introduced edges: [";
+            for (auto i = 0; i < introduceEdges.size(); ++i)
+            {
+                ret += std::string("(") + std::to_string(introduceEdges[i].first) + std::string(",") + std::to_string(introduceEdges[i].second) + std::string(")");
+                if (i + 1 < introduceEdges.size())
+                {
+                    ret += std::string(", ");
+                }
+            }
+            ret += "]";
+        }
+        return ret;
+    }
+
+    std::string toStringState() const
+    {
+        std::string ret = std::string("");
+        for (std::size_t index = 0; index < c.size(); ++index)
+        {
+            ret += std::string("Coloring NR.") + std::to_string(index) + std::string("(c=") + std::to_string(c[index]) + std::string("):\n");
+            const auto coloring = indexed::PackedColoring::fromIndex(index, bagElements.size());
+            for (std::size_t position = 0; position < bagElements.size(); ++position)
+            {
+                const auto color = coloring[position];
+                ret += std::string("\tNode ") + std::to_string(bagElements[position]) + std::string(" -> ") + std::to_string(static_cast<uint8_t>(color)) + std::string("\n");
+            }
+        }
+
+        return ret;
+    }
+};
+/************************************************************************************************************************/
+
+/* Declaring Functions used for the different Bag-Types during traversal */
+// the last parameter is the number of threads a single (large) bag may be split across
+// join and forget bags record their backpointers if they are allocated (see Bag::forgetChoices/joinChoices)
+template<typename Value>
+void introduceVertexNode(Bag<Value> * const, const Bag<Value> * const, std::size_t);
+template<typename Value>
+void joinNode(Bag<Value> * const, const Bag<Value> * const, const Bag<Value> * const, std::size_t);
+template<typename Value>
+void forgetNode(Bag<Value> * const, const Bag<Value> * const, std::size_t);
+/**
+ * Additionally to the common bag-types 'introduceEdges' is necessary as a way to 
+ * introduce the edges of a bag between two vertices in the original graph.
+ * This function is used to update the current bag-state for when we get the information, 
+ * that a vertex of the bag might not longer be required to be dominated.
+ * (By switching the value of the White/Black or Black/White colorings with the value of a
+ *  grey coloring instead of the white one). All edges of the bag are applied together.
+ */
+template<typename Value>
+void introduceEdges(Bag<Value> * const, std::size_t);
+
+/************************************************************************************************************************/
+/* Library interface */
+struct WitnessOptions
+{
+    // reconstruct a minimum dominating set, not only its size
+    bool enabled = false;
+    // 0 records the backpointers of all bags during the DP. Otherwise only the tables of every k-th level of the TD are
+    // kept, and the backpointers are recomputed from them one range of k levels at a time while walking down
+    // (about twice the time, but only the checkpoints and one range of backpointers are alive at the same time)
+    std::size_t checkpointInterval = 0;
+};
+
+// 'Auto' picks the engine of every bag with the cost model of detail::chooseEngine, 'Dense' always uses dense tables,
+// 'Sparse' uses sparse tables for all bags but the root (without backpointers, they are only recorded in dense tables)
+enum class EngineChoice
+{
+    Auto, Dense, Sparse
+};
+
+struct DominatingSetResult
+{
+    // with vertex weights the weight of a minimum weight dominating set
+    int size;
+    // peak memory of all DP-tables (and backpointers) alive at the same time
+    std::size_t peakTableBytes;
+    // a minimum dominating set (sorted), only filled if requested by WitnessOptions
+    std::vector<int> dominatingSet;
+    // number of bags processed with each engine (indexed by Engine)
+    std::array<std::size_t, 2> engineBags{};
+    // with pruning: the size (weight) of a greedy dominating set and the number of finite entries that were set to
+    // infinity
+    int upperBound = 0;
+    std::size_t prunedStates = 0;
+    // size of a table entry in bytes, the narrowest type that holds the number of vertices (the total weight)
+    std::size_t valueBytes = 0;
+    // with a spill directory: the bytes of all tables written to disk while they waited for their join
+    std::size_t spilledBytes = 0;
+};
+
+/**
+ * Instrumentation of a run, filled by minDominatingSet if one is passed (without it the DP takes no timestamps): one
+ * event per processed bag and the phases of the DP, all times in seconds since 'origin'.
+ */
+struct DPProfile
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BagEvent
+    {
+        std::size_t number;
+        BagType type;
+        Engine engine;
+        std::size_t bagSize;
+        // entries of the table of the bag (the finite ones for sparse tables) and its bytes including backpointers
+        std::size_t states;
+        std::size_t bytes;
+        std::size_t worker;
+        double start;
+        double seconds;
+    };
+
+    struct Phase
+    {
+        std::string name;
+        double start;
+        double seconds;
+    };
+
+    Clock::time_point origin = Clock::now();
+    std::vector<BagEvent> bags;
+    std::vector<Phase> phases;
+    // workers record their bags concurrently
+    std::mutex mutex;
+
+    double secondsSinceOrigin(Clock::time_point time) const
+    {
+        return std::chrono::duration<double>(time - origin).count();
+    }
+
+    // records the phase 'name' from 'start' until now, returns its length in seconds
+    double addPhase(const std::string& name, Clock::time_point start)
+    {
+        const auto now = Clock::now();
+        const auto seconds = std::chrono::duration<double>(now - start).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        phases.push_back({ name, secondsSinceOrigin(start), seconds });
+        return seconds;
+    }
+};
+
+namespace detail
+{
+
+// bag b at index b, the bags are stored contiguously
+template<typename Value>
+using Bags = std::vector<Bag<Value>>;
+
+// bags up to this size always use dense tables, the bookkeeping of sparse ones never pays off against the specialized
+// dense kernels (see indexed::small)
+constexpr std::size_t smallBagSize = indexed::small::maxBagSize;
+// the sparse kernels take several times longer per entry than the (vectorized) dense ones, but only see finite entries
+constexpr double sparseFill = 1.0 / 8;
+// the vectorized dense join is even faster per consistent triple than a sparse candidate, which has to be sorted
+constexpr double sparseJoinFill = 1.0 / 1024;
+
+/**
+ * Cost model for the engine of a bag: dense kernels touch all 3^k entries (4^k consistent triples for joins), sparse
+ * ones the finite entries of the child (plus a binary search per changed entry for edges). Introduce and forget bags
+ * inherit the fill of their child, so a bag is sparse if its child is sparse enough. A sparse join combines about
+ * fill1 * fill2 * 4^k pairs of entries (random colorings are consistent with probability (4/9)^k), which is compared
+ * with the dense 4^k with its own threshold. Backpointers and small bags are dense.
+ */
+template<typename Value>
+Engine chooseEngine(const Bags<Value>& bags, const Bag<Value>& bag, EngineChoice choice, bool recordChoices)
+{
+    if (choice == EngineChoice::Dense || recordChoices || !bag.parentNumber.has_value())
+    {
+        return Engine::Dense;
+    }
+    if (choice == EngineChoice::Sparse)
+    {
+        return Engine::Sparse;
+    }
+    if (bag.bagElements.size() <= smallBagSize || bag.type == BagType::Leaf)
+    {
+        return Engine::Dense;
+    }
+    const auto fill = bags[bag.child1.value()].fill();
+    if (bag.type == BagType::Join)
+    {
+        return fill * bags[bag.child2.value()].fill() < sparseJoinFill ? Engine::Sparse : Engine::Dense;
+    }
+    return fill < sparseFill ? Engine::Sparse : Engine::Dense;
+}
+
+/**
+ * The graph of a labelled nice-TD: its vertices are the vertices of the bags (as sorted ids, the index in 'vertices'
+ * is the number of a vertex) and every edge is introduced at exactly one bag.
+ * Throws std::invalid_argument for an introduce edge to a vertex that is in no bag, makeBags checks the rest.
+ */
+struct NiceTDGraph
+{
+    std::vector<int> vertices;
+    std::vector<std::vector<std::size_t>> neighbors;
+
+    template<typename NiceTD>
+    explicit NiceTDGraph(const NiceTD& niceBags)
+    {
+        for (std::size_t number = 0; number < niceBags.size(); ++number)
+        {
+            const auto &bag = niceBags[number];
+            vertices.insert(vertices.end(), bag.vertices.cbegin(), bag.vertices.cend());
+        }
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        neighbors.resize(vertices.size());
+        for (std::size_t number = 0; number < niceBags.size(); ++number)
+        {
+            const auto &bag = niceBags[number];
+            for (const auto &[u, v] : bag.introduceEdges)
+            {
+                if (!std::binary_search(vertices.cbegin(), vertices.cend(), u) ||
+                    !std::binary_search(vertices.cbegin(), vertices.cend(), v))
+                {
+                    throw std::invalid_argument("bag " + std::to_string(number) +
+                        " introduces an edge to a vertex in no bag");
+                }
+                neighbors[numberOf(u)].push_back(numberOf(v));
+                neighbors[numberOf(v)].push_back(numberOf(u));
+            }
+        }
+    }
+
+    std::size_t numberOf(int vertex) const
+    {
+        return static_cast<std::size_t>(std::lower_bound(vertices.cbegin(), vertices.cend(), vertex) - vertices.cbegin());
+    }
+};
+
+/**
+ * Greedy dominating set: repeatedly takes the vertex that dominates the most undominated vertices (per weight, with
+ * 'weights' indexed by vertex id, empty for unit weights). The gains in the queue are only updated when they are
+ * popped, they can only shrink, so a popped vertex whose gain is still correct is the best one.
+ * The vertices in 'preDominated' (indexed by vertex id, may be empty) start as dominated.
+ */
+inline std::vector<int> greedyDominatingSet(const NiceTDGraph& graph, const std::vector<std::uint32_t>& weights = {},
+    const std::vector<bool>& preDominated = {})
+{
+    std::vector<bool> dominated(graph.vertices.size(), false);
+    for (std::size_t vertex = 0; vertex < graph.vertices.size() && !preDominated.empty(); ++vertex)
+    {
+        dominated[vertex] = preDominated[graph.vertices[vertex]];
+    }
+    const auto gainOf = [&graph, &dominated, &weights](std::size_t vertex)
+    {
+        std::size_t gain = !dominated[vertex];
+        for (const auto neighbor : graph.neighbors[vertex])
+        {
+            gain += !dominated[neighbor];
+        }
+        if (weights.empty() || gain == 0)
+        {
+            return static_cast<double>(gain);
+        }
+        const auto weight = weights[graph.vertices[vertex]];
+        return weight == 0 ? std::numeric_limits<double>::infinity() : static_cast<double>(gain) / weight;
+    };
+    std::vector<std::pair<double, std::size_t>> queue;
+    for (std::size_t vertex = 0; vertex < graph.vertices.size(); ++vertex)
+    {
+        queue.emplace_back(gainOf(vertex), vertex);
+    }
+    std::make_heap(queue.begin(), queue.end());
+    std::vector<int> dominatingSet;
+    while (!queue.empty())
+    {
+        std::pop_heap(queue.begin(), queue.end());
+        const auto [gain, vertex] = queue.back();
+        queue.pop_back();
+        const auto current = gainOf(vertex);
+        if (current == 0)
+        {
+            continue;
+        }
+        if (current < gain)
+        {
+            queue.emplace_back(current, vertex);
+            std::push_heap(queue.begin(), queue.end());
+            continue;
+        }
+        dominatingSet.push_back(graph.vertices[vertex]);
+        dominated[vertex] = true;
+        for (const auto neighbor : graph.neighbors[vertex])
+        {
+            dominated[neighbor] = true;
+        }
+    }
+    return dominatingSet;
+}
+
+/**
+ * Sets Bag::pruneAbove for a global upper bound U on the solution: the r vertices that are not in the subtree of a bag
+ * (neither forgotten below it nor in it) are dominated by the black vertices of the bag or by vertices outside of the
+ * subtree, each of them dominates at most maxDegree + 1 vertices. So every completion of an entry with value x has
+ * size at least x + ceil(r / (maxDegree + 1)) - |bag|, and entries above U minus this lower bound are not needed.
+ * With vertex weights each of these vertices costs at least 'minWeight'. Vertices in 'preDominated' (indexed by vertex
+ * id, may be empty) do not need to be dominated and are not counted in r.
+ */
+template<typename Value>
+void pruneLimits(Bags<Value>& bags, const NiceTDGraph& graph, int upperBound, std::uint32_t minWeight = 1,
+    const std::vector<bool>& preDominated = {})
+{
+    const auto needsDomination = [&preDominated](int vertex) -> std::size_t
+    {
+        return preDominated.empty() || !preDominated[vertex];
+    };
+    std::size_t undominated = 0;
+    for (const auto vertex : graph.vertices)
+    {
+        undominated += needsDomination(vertex);
+    }
+    std::size_t maxDegree = 0;
+    for (const auto &neighbors : graph.neighbors)
+    {
+        maxDegree = std::max(maxDegree, neighbors.size());
+    }
+    // every vertex is forgotten exactly once (by a forget bag or the root), parents have smaller numbers
+    std::vector<std::size_t> forgotten(bags.size(), 0);
+    for (auto number = bags.size(); number-- > 0;)
+    {
+        const auto bag = &bags[number];
+        if (bag->type == BagType::Forget || !bag->parentNumber.has_value())
+        {
+            const auto child = &bags[bag->child1.value()];
+            forgotten[number] += needsDomination(child->bagElements[bag->changedPosition]);
+        }
+        if (bag->parentNumber.has_value())
+        {
+            forgotten[bag->parentNumber.value()] += forgotten[number];
+        }
+    }
+    for (std::size_t number = 0; number < bags.size(); ++number)
+    {
+        const auto bag = &bags[number];
+        std::size_t inBag = 0;
+        for (const auto vertex : bag->bagElements)
+        {
+            inBag += needsDomination(vertex);
+        }
+        const auto rest = undominated - forgotten[number] - inBag;
+        const auto restBound = static_cast<int>((rest + maxDegree) / (maxDegree + 1)) - static_cast<int>(bag->bagElements.size());
+        bag->pruneAbove = static_cast<Value>(upperBound - std::max(0, restBound) * static_cast<int>(minWeight));
+    }
+}
+
+// runs the bag-logic of a bag whose children are done, with backpointers if 'recordChoices' is set
+// returns the number of pruned entries
+template<typename Value>
+std::size_t processBag(Bags<Value>& bags, std::size_t number, indexed::TableMemory& memory, std::size_t threads,
+    bool recordChoices, EngineChoice choice = EngineChoice::Dense)
+{
+    const auto bag = &bags[number];
+    for (const auto &child : { bag->child1, bag->child2 })
+    {
+        if (child.has_value())
+        {
+            bags[child.value()].restoreState(memory);
+        }
+    }
+    bag->engine = chooseEngine(bags, *bag, choice, recordChoices);
+    for (const auto &child : { bag->child1, bag->child2 })
+    {
+        if (child.has_value())
+        {
+            bags[child.value()].convertState(bag->engine, memory);
+        }
+    }
+    bag->allocateState(memory);
+
+    if (!bag->parentNumber.has_value())
+    {
+        // the root forgets the last vertex, its only coloring (the empty one) holds the min cost
+        const auto child = &bags[bag->child1.value()];
+        assert(child->bagElements.size() == 1); // property of nice TD
+        if (recordChoices)
+        {
+            memory.allocateChoices(bag->forgetChoices, bag->bagElements.size());
+        }
+        forgetNode(bag, child, threads);
+    }
+    else if (bag->type == BagType::Intro)
+    {
+        introduceVertexNode(bag, &bags[bag->child1.value()], threads);
+    }
+    else if (bag->type == BagType::Forget)
+    {
+        if (recordChoices)
+        {
+            memory.allocateChoices(bag->forgetChoices, bag->bagElements.size());
+        }
+        forgetNode(bag, &bags[bag->child1.value()], threads);
+    }
+    else if (bag->type == BagType::Join)
+    {
+        if (recordChoices)
+        {
+            memory.allocateChoices(bag->joinChoices, bag->bagElements.size());
+        }
+        joinNode(bag, &bags[bag->child1.value()], &bags[bag->child2.value()], threads);
+    }
+
+    introduceEdges(bag, threads);
+    std::size_t pruned = 0;
+    if (bag->pruneAbove != indexed::infinity<Value>)
+    {
+        pruned = bag->engine == Engine::Sparse ? sparse::prune(bag->sparseC, bag->pruneAbove) :
+            indexed::prune(bag->c, bag->pruneAbove);
+    }
+    if (bag->engine == Engine::Sparse)
+    {
+        memory.account(bag->sparseC.bytes());
+    }
+    return pruned;
+}
+
+/**
+ * One step of the reconstruction: given the index of the chosen coloring of a processed bag, appends the colorings of
+ * its children that produced its value to 'next' and the vertices that become black in this bag to 'dominatingSet'.
+ * Frees the backpointers of the bag.
+ */
+template<typename Value>
+void traceBag(Bags<Value>& bags, std::size_t number, std::size_t index, indexed::TableMemory& memory,
+    std::vector<std::pair<std::size_t, std::size_t>>& next, std::vector<int>& dominatingSet)
+{
+    const auto bag = &bags[number];
+    auto coloring = indexed::PackedColoring::fromIndex(index, bag->bagElements.size());
+    // undo the introduce edges, the last one first: a white vertex with a black neighbor took its grey coloring
+    for (auto edge = bag->edgePositions.crbegin(); edge != bag->edgePositions.crend(); ++edge)
+    {
+        const auto [u, v] = *edge;
+        if (coloring[u] == Color::Black && coloring[v] == Color::White)
+        {
+            coloring.set(v, Color::Grey);
+        }
+        else if (coloring[u] == Color::White && coloring[v] == Color::Black)
+        {
+            coloring.set(u, Color::Grey);
+        }
+    }
+    index = coloring.index(bag->bagElements.size());
+
+    if (!bag->parentNumber.has_value() || bag->type == BagType::Forget)
+    {
+        const auto child = &bags[bag->child1.value()];
+        const auto color = bag->forgetChoices[index] ? Color::Black : Color::White;
+        next.emplace_back(child->number, coloring.inserted(bag->changedPosition, color).index(child->bagElements.size()));
+        memory.release(bag->forgetChoices);
+    }
+    else if (bag->type == BagType::Intro)
+    {
+        const auto child = &bags[bag->child1.value()];
+        const auto position = bag->changedPosition;
+        const auto v = bag->bagElements[position];
+        // white is only possible with infinite cost (unless the vertex is dominated already), so it is never chosen
+        assert(coloring[position] != Color::White || bag->dominatedVertex);
+        if (coloring[position] == Color::Black)
+        {
+            dominatingSet.push_back(v);
+        }
+        next.emplace_back(child->number, coloring.erased(position).index(child->bagElements.size()));
+    }
+    else if (bag->type == BagType::Join)
+    {
+        const auto whiteInChild1 = bag->joinChoices[index];
+        auto coloring1 = coloring;
+        auto coloring2 = coloring;
+        for (std::size_t position = 0; position < bag->bagElements.size(); ++position)
+        {
+            if (coloring[position] == Color::White)
+            {
+                ((whiteInChild1 >> position) & 1 ? coloring2 : coloring1).set(position, Color::Grey);
+            }
+        }
+        next.emplace_back(bag->child1.value(), coloring1.index(bag->bagElements.size()));
+        next.emplace_back(bag->child2.value(), coloring2.index(bag->bagElements.size()));
+        memory.release(bag->joinChoices);
+    }
+}
+
+/**
+ * Order of the subtrees of join bags that minimizes the peak of the live tables (Sethi-Ullman): the table of the
+ * subtree that is processed first lives while the other one is processed, so the subtree that needs more memory goes
+ * first. need(bag) is the peak of its subtree in dense table bytes, returns which joins process child2 first.
+ */
+template<typename Value>
+std::vector<bool> heavierChildFirst(const Bags<Value>& bags)
+{
+    const auto bytes = [&bags](std::size_t number)
+    {
+        return static_cast<double>(indexed::pow3(bags[number].bagElements.size())) * sizeof(Value);
+    };
+    std::vector<double> need(bags.size(), 0);
+    std::vector<bool> child2First(bags.size(), false);
+    // children have larger numbers than their parent
+    for (auto number = bags.size(); number-- > 0;)
+    {
+        const auto bag = &bags[number];
+        if (!bag->child1.has_value())
+        {
+            need[number] = bytes(number);
+        }
+        else if (!bag->child2.has_value())
+        {
+            const auto child = bag->child1.value();
+            need[number] = std::max(need[child], bytes(child) + bytes(number));
+        }
+        else
+        {
+            const auto child1 = bag->child1.value();
+            const auto child2 = bag->child2.value();
+            const auto need1First = std::max(need[child1], bytes(child1) + need[child2]);
+            const auto need2First = std::max(need[child2], bytes(child2) + need[child1]);
+            child2First[number] = need2First < need1First;
+            need[number] = std::max(std::min(need1First, need2First), bytes(child1) + bytes(child2) + bytes(number));
+        }
+    }
+    return child2First;
+}
+
+// appends the event of a bag processed by 'worker' since 'start'
+template<typename Value>
+void recordBag(DPProfile& profile, const Bag<Value>& bag, std::size_t worker, DPProfile::Clock::time_point start)
+{
+    const auto seconds = std::chrono::duration<double>(DPProfile::Clock::now() - start).count();
+    const auto bytes = bag.stateBytes() + bag.forgetChoices.capacity() * sizeof(indexed::ForgetChoices::value_type) +
+        bag.joinChoices.capacity() * sizeof(indexed::JoinChoices::value_type);
+    std::lock_guard<std::mutex> lock(profile.mutex);
+    profile.bags.push_back({ bag.number, bag.type, bag.engine, bag.bagElements.size(), bag.stateEntries(), bytes, worker,
+        profile.secondsSinceOrigin(start), seconds });
+}
+
+// tables below this size stay in memory while they wait for their join, writing them costs more than they occupy
+constexpr std::size_t minSpillBytes = std::size_t{ 1 } << 16;
+
+/**
+ * The bags of a labelled nice-TD with their children and positions, without tables.
+ * Throws std::invalid_argument if 'niceBags' does not have the shape required by minDominatingSet: leaves are empty
+ * and have no children, introduce and forget bags have one child that lacks one vertex of the bag or has one more, the
+ * root (numbered 0) forgets the single vertex of its only child, joins have two children with the same vertices, no
+ * bag holds a vertex twice and every introduce edge is between vertices of its bag.
+ */
+template<typename Value, typename NiceTD>
+Bags<Value> makeBags(const NiceTD& niceBags)
+{
+    if (niceBags.empty() || niceBags.front().parent.has_value() || !niceBags.front().vertices.empty())
+    {
+        throw std::invalid_argument("the root of the nice-TD must be an empty bag with number 0");
+    }
+    if (niceBags.size() > std::numeric_limits<BagNumber>::max())
+    {
+        throw std::invalid_argument("the nice-TD has too many bags");
+    }
+    Bags<Value> bags;
+    bags.reserve(niceBags.size());
+    for (std::size_t number = 0; number < niceBags.size(); ++number)
+    {
+        const auto &niceBag = niceBags[number];
+        if (number > 0 && (!niceBag.parent.has_value() || niceBag.parent.value() >= number))
+        {
+            throw std::invalid_argument("bag " + std::to_string(number) + " needs a parent with a smaller number");
+        }
+        if (niceBag.vertices.size() > indexed::maxBagSize)
+        {
+            throw std::invalid_argument("bag " + std::to_string(number) + " is too large for the DP-tables");
+        }
+        std::vector<int> vertices(niceBag.vertices.begin(), niceBag.vertices.end());
+        std::sort(vertices.begin(), vertices.end());
+        if (std::adjacent_find(vertices.cbegin(), vertices.cend()) != vertices.cend())
+        {
+            throw std::invalid_argument("bag " + std::to_string(number) + " holds a vertex twice");
+        }
+        if (niceBag.type == BagType::Leaf && !vertices.empty())
+        {
+            throw std::invalid_argument("leaf bag " + std::to_string(number) + " is not empty");
+        }
+        std::vector<std::pair<int, int>> edges(niceBag.introduceEdges.begin(), niceBag.introduceEdges.end());
+        for (const auto &[u, v] : edges)
+        {
+            if (!std::binary_search(vertices.cbegin(), vertices.cend(), u) ||
+                !std::binary_search(vertices.cbegin(), vertices.cend(), v))
+            {
+                throw std::invalid_argument("bag " + std::to_string(number) +
+                    " introduces an edge to a vertex outside of it");
+            }
+        }
+        const auto parentNumber = niceBag.parent.has_value() ?
+            std::make_optional(static_cast<BagNumber>(niceBag.parent.value())) : std::nullopt;
+        bags.emplace_back(static_cast<BagNumber>(number), niceBag.type, parentNumber, std::move(vertices),
+            std::move(edges));
+    }
+
+    // set children in all bags
+    for (const auto &bag : bags)
+    {
+        if (bag.parentNumber.has_value())
+        {
+            auto &parent = bags[bag.parentNumber.value()];
+            if (!parent.child1.has_value())
+            {
+                parent.child1 = std::make_optional(bag.number);
+            }
+            else if (!parent.child2.has_value())
+            {
+                parent.child2 = std::make_optional(bag.number);
+            }
+            else
+            {
+                throw std::invalid_argument("bag " + std::to_string(parent.number) + " has more than two children");
+            }
+        }
+    }
+    // the vertices of every bag against the ones of its children, all still sorted
+    const auto addsOneVertex = [](const std::vector<int>& larger, const std::vector<int>& smaller)
+    {
+        return larger.size() == smaller.size() + 1 &&
+            std::includes(larger.cbegin(), larger.cend(), smaller.cbegin(), smaller.cend());
+    };
+    for (const auto &bag : bags)
+    {
+        const auto name = "bag " + std::to_string(bag.number);
+        const std::size_t children = bag.child1.has_value() + bag.child2.has_value();
+        // the root forgets like a forget bag, whatever its type
+        const auto type = bag.parentNumber.has_value() ? bag.type : BagType::Forget;
+        const std::size_t required = type == BagType::Leaf ? 0 : type == BagType::Join ? 2 : 1;
+        if (children != required)
+        {
+            throw std::invalid_argument(name + " has " + std::to_string(children) + " children instead of " +
+                std::to_string(required));
+        }
+        if (type == BagType::Intro && !addsOneVertex(bag.bagElements, bags[bag.child1.value()].bagElements))
+        {
+            throw std::invalid_argument(name + " does not introduce exactly one vertex to its child");
+        }
+        if (type == BagType::Forget && !addsOneVertex(bags[bag.child1.value()].bagElements, bag.bagElements))
+        {
+            throw std::invalid_argument(name + " does not forget exactly one vertex of its child");
+        }
+        if (type == BagType::Join && (bag.bagElements != bags[bag.child1.value()].bagElements ||
+            bag.bagElements != bags[bag.child2.value()].bagElements))
+        {
+            throw std::invalid_argument("join " + name + " does not have the vertices of both children");
+        }
+    }
+    // digit orders from the root down: a bag keeps the order of its parent, and the vertex that the parent forgets
+    // becomes its highest digit. So every forget is a block-wise min of the three slices of the child table and the
+    // children of a join agree on the order without permuting a table, only introduces see any position.
+    for (std::size_t number = 1; number < bags.size(); ++number)
+    {
+        auto &bag = bags[number];
+        const auto &parent = bags[bag.parentNumber.value()];
+        std::vector<int> order;
+        std::copy_if(parent.bagElements.cbegin(), parent.bagElements.cend(), std::back_inserter(order),
+            [&bag](int vertex) { return std::binary_search(bag.bagElements.cbegin(), bag.bagElements.cend(), vertex); });
+        for (const auto vertex : bag.bagElements)
+        {
+            if (std::find(parent.bagElements.cbegin(), parent.bagElements.cend(), vertex) == parent.bagElements.cend())
+            {
+                order.push_back(vertex);
+            }
+        }
+        bag.setDigitOrder(std::move(order));
+    }
+    for (auto &bag : bags)
+    {
+        if (bag.type == BagType::Intro || bag.type == BagType::Forget || !bag.parentNumber.has_value())
+        {
+            bag.locateChangedVertex(bags[bag.child1.value()]);
+        }
+    }
+    return bags;
+}
+
+// weight of a set of vertices, its size for unit weights
+inline std::uint64_t weightOf(const std::vector<int>& vertices, const std::vector<std::uint32_t>& weights)
+{
+    if (weights.empty())
+    {
+        return vertices.size();
+    }
+    std::uint64_t weight = 0;
+    for (const auto vertex : vertices)
+    {
+        weight += weights[vertex];
+    }
+    return weight;
+}
+
+// minDominatingSet with tables of 'Value' entries
+template<typename Value, typename NiceTD>
+DominatingSetResult solve(const NiceTD& niceBags, const NiceTDGraph& graph, std::size_t threadCount,
+    WitnessOptions witness, EngineChoice engines, bool prune, indexed::TableMemory* tables,
+    const std::string& spillDirectory, DPProfile* profile, const std::vector<std::uint32_t>& weights,
+    const std::vector<bool>& dominated)
+{
+    auto bags = detail::makeBags<Value>(niceBags);
+    if (!weights.empty())
+    {
+        for (auto &bag : bags)
+        {
+            bag.setWeights(weights);
+        }
+    }
+    if (!dominated.empty())
+    {
+        for (auto &bag : bags)
+        {
+            bag.dominatedVertex = bag.type == BagType::Intro && bag.parentNumber.has_value() &&
+                dominated[bag.bagElements[bag.changedPosition]];
+        }
+    }
+
+    int upperBound = 0;
+    if (prune)
+    {
+        const auto greedy = detail::greedyDominatingSet(graph, weights, dominated);
+        upperBound = static_cast<int>(weightOf(greedy, weights));
+        std::uint32_t minWeight = 1;
+        if (!weights.empty())
+        {
+            minWeight = std::numeric_limits<std::uint32_t>::max();
+            for (const auto vertex : graph.vertices)
+            {
+                minWeight = std::min(minWeight, weights[vertex]);
+            }
+        }
+        detail::pruneLimits(bags, graph, upperBound, minWeight, dominated);
+    }
+
+    // tables of checkpoints stay alive after the DP, parents have smaller numbers so depths are known in order
+    const auto interval = witness.enabled ? witness.checkpointInterval : 0;
+    std::vector<std::size_t> depth(bags.size(), 0);
+    for (std::size_t number = 1; number < bags.size(); ++number)
+    {
+        depth[number] = depth[bags[number].parentNumber.value()] + 1;
+    }
+    const auto isCheckpoint = [&depth, interval](std::size_t number) { return interval > 0 && depth[number] % interval == 0; };
+
+    // process every bag as soon as its children are done, independent subtrees of join bags run in parallel
+    // a worker descends into the first child of a node, which is the one of the heavier subtree
+    const auto child2First = detail::heavierChildFirst(bags);
+    std::vector<TreeScheduler::Node> tree;
+    tree.reserve(bags.size());
+    for (const auto &bag : bags)
+    {
+        const auto swapped = child2First[bag.number];
+        tree.push_back({ bag.parentNumber, swapped ? bag.child2 : bag.child1, swapped ? bag.child1 : bag.child2 });
+    }
+    TreeScheduler scheduler(tree, threadCount);
+    indexed::TableMemory ownTables;
+    auto &memory = tables != nullptr ? *tables : ownTables;
+    memory.resetPeak();
+    const auto recordChoices = witness.enabled && interval == 0;
+    std::atomic<std::size_t> prunedStates{ 0 };
+    // children of each join that are done, the first one waits for the subtree of the other one and can be spilled
+    std::vector<std::atomic<std::uint8_t>> doneChildren(spillDirectory.empty() ? 0 : bags.size());
+    std::atomic<std::size_t> spilledBytes{ 0 };
+    const auto tablesStart = DPProfile::Clock::now();
+    // workers without a subtree to process help with the work inside of a bag, the kernels hand them their chunks
+    const indexed::Helpers helpers = [&scheduler](std::size_t count, const std::function<void()>& work)
+    {
+        scheduler.helpWith(count, work);
+    };
+    const std::function<void(std::size_t, std::size_t)> processBag =
+        [&bags, &memory, &scheduler, &helpers, &isCheckpoint, &prunedStates, &doneChildren, &spilledBytes,
+            &spillDirectory, profile, recordChoices, engines](std::size_t number, std::size_t worker) -> void
+    {
+        const auto bag = &bags[number];
+        const auto start = profile != nullptr ? DPProfile::Clock::now() : DPProfile::Clock::time_point{};
+        const indexed::ScopedHelpers scope(&helpers);
+        prunedStates += detail::processBag(bags, number, memory, 1 + scheduler.idleWorkers(), recordChoices, engines);
+        if (profile != nullptr)
+        {
+            detail::recordBag(*profile, *bag, worker, start);
+        }
+        if (!doneChildren.empty() && bag->parentNumber.has_value() &&
+            bags[bag->parentNumber.value()].type == BagType::Join &&
+            doneChildren[bag->parentNumber.value()].fetch_add(1) == 0 &&
+            bag->stateBytes() >= detail::minSpillBytes)
+        {
+            // bags of concurrent runs of a process live at different addresses, their files do not clash
+            const auto name = "mds-table-" + std::to_string(getpid()) + "-" +
+                std::to_string(reinterpret_cast<std::uintptr_t>(bag)) + ".bin";
+            spilledBytes += bag->spillState(spillDirectory + "/" + name, memory);
+        }
+
+        // the children are not needed anymore
+        for (const auto &child : { bags[number].child1, bags[number].child2 })
+        {
+            if (child.has_value() && !isCheckpoint(child.value()))
+            {
+                bags[child.value()].releaseState(memory);
+            }
+        }
+    };
+    scheduler.run(0, processBag);
+    if (profile != nullptr)
+    {
+        profile->addPhase("tables", tablesStart);
+    }
+    const auto rootValue = bags[0].c.front();
+    const auto minDominatingSetSize = rootValue == indexed::infinity<Value> ? std::numeric_limits<int>::max() :
+        static_cast<int>(rootValue);
+    DominatingSetResult result{ minDominatingSetSize, 0, {}, {}, upperBound, prunedStates, sizeof(Value), spilledBytes };
+    for (const auto &bag : bags)
+    {
+        result.engineBags[static_cast<std::size_t>(bag.engine)]++;
+    }
+
+    if (witness.enabled && rootValue != indexed::infinity<Value>)
+    {
+        const auto witnessStart = DPProfile::Clock::now();
+        // walk down from the empty coloring of the root, following the backpointers
+        std::vector<std::pair<std::size_t, std::size_t>> pending{ { 0, 0 } };
+        while (!pending.empty())
+        {
+            const auto [regionRoot, regionIndex] = pending.back();
+            pending.pop_back();
+            std::vector<std::pair<std::size_t, std::size_t>> next{ { regionRoot, regionIndex } };
+            if (interval > 0)
+            {
+                // recompute the backpointers of the levels [depth, depth + interval) below this checkpoint, the
+                // checkpoints of the next range hold the tables they start from
+                std::vector<std::size_t> region{ regionRoot };
+                for (std::size_t i = 0; i < region.size(); ++i)
+                {
+                    for (const auto &child : { bags[region[i]].child1, bags[region[i]].child2 })
+                    {
+                        if (child.has_value() && !isCheckpoint(child.value()))
+                        {
+                            region.push_back(child.value());
+                        }
+                    }
+                }
+                bags[regionRoot].releaseState(memory);
+                std::sort(region.begin(), region.end(), std::greater<>());
+                for (const auto number : region)
+                {
+                    detail::processBag(bags, number, memory, threadCount, true);
+                    for (const auto &child : { bags[number].child1, bags[number].child2 })
+                    {
+                        if (child.has_value())
+                        {
+                            bags[child.value()].releaseState(memory);
+                        }
+                    }
+                }
+                bags[regionRoot].releaseState(memory);
+            }
+            while (!next.empty())
+            {
+                const auto [number, index] = next.back();
+                next.pop_back();
+                std::vector<std::pair<std::size_t, std::size_t>> children;
+                detail::traceBag(bags, number, index, memory, children, result.dominatingSet);
+                for (const auto &child : children)
+                {
+                    (interval > 0 && isCheckpoint(child.first) ? pending : next).push_back(child);
+                }
+            }
+        }
+        // a vertex in the solution is introduced as black in every branch of a join that contains it
+        std::sort(result.dominatingSet.begin(), result.dominatingSet.end());
+        result.dominatingSet.erase(std::unique(result.dominatingSet.begin(), result.dominatingSet.end()),
+            result.dominatingSet.end());
+        assert(weightOf(result.dominatingSet, weights) == static_cast<std::uint64_t>(minDominatingSetSize));
+        if (profile != nullptr)
+        {
+            profile->addPhase("witness", witnessStart);
+        }
+    }
+    bags[0].releaseState(memory);
+    result.peakTableBytes = memory.peakBytes;
+    return result;
+}
+
+} // namespace detail
+
+/**
+ * Runs the DP on a labelled nice-TD: bag 0 is the empty root, every other bag has a parent with a smaller number.
+ * With 'prune' the size of a greedy dominating set bounds the values of all tables (see detail::pruneLimits).
+ * The tables are allocated from 'tables' if given, which keeps its pool of table buffers for the next run.
+ * With a 'spillDirectory' the tables of join branches that wait for the other branch are written to files there and
+ * read back by the join, only the tables on the current path of the traversal stay in memory.
+ * A 'profile' receives one event per bag and the phases of the run.
+ * With 'weights' (indexed by vertex id, one for every vertex of the nice-TD) it minimizes the total weight of the
+ * dominating set instead of its size, the weight of all vertices has to fit into an int.
+ * The vertices in 'dominated' (indexed by vertex id, empty for none) are dominated already, e.g. by vertices that a
+ * reduction took into the solution (see reduceGraph): they may stay white without a black neighbor.
+ * 'niceBags' is a std::vector<NiceBag> or a MappedNiceTD (niceTdCache.hpp), whose bags are read from the mapped file.
+ * Throws std::invalid_argument if 'niceBags' does not have this shape or the weights do not fit.
+ */
+template<typename NiceTD>
+DominatingSetResult minDominatingSet(const NiceTD& niceBags, std::size_t threadCount = 1,
+    WitnessOptions witness = {}, EngineChoice engines = EngineChoice::Auto, bool prune = false,
+    indexed::TableMemory* tables = nullptr, const std::string& spillDirectory = {}, DPProfile* profile = nullptr,
+    const std::vector<std::uint32_t>& weights = {}, const std::vector<bool>& dominated = {})
+{
+    // values never exceed the number of vertices (the total weight), infinity has to stay above them
+    const detail::NiceTDGraph graph(niceBags);
+    if (!weights.empty() && !graph.vertices.empty() &&
+        (graph.vertices.front() < 0 || static_cast<std::size_t>(graph.vertices.back()) >= weights.size()))
+    {
+        throw std::invalid_argument("every vertex of the nice-TD needs a weight");
+    }
+    if (!dominated.empty() && !graph.vertices.empty() &&
+        (graph.vertices.front() < 0 || static_cast<std::size_t>(graph.vertices.back()) >= dominated.size()))
+    {
+        throw std::invalid_argument("the dominated vertices have to cover every vertex of the nice-TD");
+    }
+    const auto totalWeight = detail::weightOf(graph.vertices, weights);
+    if (totalWeight >= static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+    {
+        throw std::invalid_argument("the total weight of the vertices is too large");
+    }
+    if (totalWeight < indexed::infinity<std::uint8_t>)
+    {
+        return detail::solve<std::uint8_t>(niceBags, graph, threadCount, witness, engines, prune, tables, spillDirectory,
+            profile, weights, dominated);
+    }
+    if (totalWeight < indexed::infinity<std::uint16_t>)
+    {
+        return detail::solve<std::uint16_t>(niceBags, graph, threadCount, witness, engines, prune, tables, spillDirectory,
+            profile, weights, dominated);
+    }
+    return detail::solve<std::uint32_t>(niceBags, graph, threadCount, witness, engines, prune, tables, spillDirectory,
+        profile, weights, dominated);
+}
+
+// convenience overload for a graph and an arbitrary (not nice) TD of it, see makeOptimizedNiceTreeDecomposition
+inline DominatingSetResult minDominatingSet(const Graph& graph, const TreeDecomposition& td, std::size_t threadCount = 1,
+    WitnessOptions witness = {}, EngineChoice engines = EngineChoice::Auto, bool prune = false)
+{
+    return minDominatingSet(makeOptimizedNiceTreeDecomposition(graph, td), threadCount, witness, engines, prune);
+}
+
+/************************************************************************************************************************/
+/* Bag-logic functions */
+template<typename Value>
+void introduceEdges(Bag<Value> * const bag, std::size_t threads)
+{
+    if (bag->engine == Engine::Sparse)
+    {
+        for (const auto &[u, v] : bag->edgePositions)
+        {
+            sparse::introduceEdge(bag->sparseC, u, v);
+        }
+        return;
+    }
+    indexed::introduceEdges(bag->c, bag->edgePositions, threads);
+}
+
+// the cost policy of the kernels of a bag (see indexed::UnitCost), 'with' runs the kernel for it
+template<typename Value, typename Kernel>
+void withCost(const Bag<Value> * const bag, const Kernel& with)
+{
+    if (bag->weights.empty())
+    {
+        with(indexed::UnitCost{});
+    }
+    else
+    {
+        with(indexed::VertexCost{ bag->weights.data() });
+    }
+}
+
+template<typename Value>
+void joinNode(Bag<Value> * const bag, const Bag<Value> * const child1, const Bag<Value> * const child2, std::size_t threads)
+{
+    assert(bag->bagElements == child1->bagElements && bag->bagElements == child2->bagElements);
+    withCost(bag, [&](const auto& cost)
+    {
+        if (bag->engine == Engine::Sparse)
+        {
+            sparse::join(bag->sparseC, child1->sparseC, child2->sparseC, bag->bagElements.size(), cost);
+            return;
+        }
+        indexed::join(bag->c, child1->c, child2->c, bag->bagElements.size(), threads,
+            bag->joinChoices.empty() ? nullptr : &bag->joinChoices, cost);
+    });
+}
+
+template<typename Value>
+void forgetNode(Bag<Value> * const bag, const Bag<Value> * const child, std::size_t threads)
+{
+    if (bag->engine == Engine::Sparse)
+    {
+        sparse::forgetVertex(bag->sparseC, child->sparseC, bag->changedPosition);
+        return;
+    }
+    indexed::forgetVertex(bag->c, child->c, bag->changedPosition, threads,
+        bag->forgetChoices.empty() ? nullptr : &bag->forgetChoices);
+}
+
+template<typename Value>
+void introduceVertexNode(Bag<Value> * const bag, const Bag<Value> * const child, std::size_t threads)
+{
+    withCost(bag, [&](const auto& cost)
+    {
+        if (bag->engine == Engine::Sparse)
+        {
+            sparse::introduceVertex(bag->sparseC, child->sparseC, bag->changedPosition, cost);
+            return;
+        }
+        indexed::introduceVertex(bag->c, child->c, bag->changedPosition, threads, cost);
+    });
+    if (bag->dominatedVertex)
+    {
+        if (bag->engine == Engine::Sparse)
+        {
+            sparse::dominateVertex(bag->sparseC, bag->changedPosition);
+        }
+        else
+        {
+            indexed::dominateVertex(bag->c, bag->changedPosition, threads);
+        }
+    }
+}
@@ -0,0 +1,439 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "treeDecomposition.hpp"
+
+/**
+ * Binary file format for labelled nice-TDs, so the (NP-hard) TD computation and the nice-TD construction only have to
+ * run once per graph. Written by read.py (output path ending in '.ntd') or by writeNiceTDCache, mapped by MappedNiceTD.
+ *
+ * Layout, native byte order, all arrays 4-byte aligned:
+ *   header     'NTD\0', uint32 version, uint64 bagCount, uint64 vertexCount, uint64 edgeCount,
+ *              uint64 graphVertexCount, uint64 graphEdgeCount, uint64 graphEdgeHash (the GraphFingerprint)
+ *   int32      parents[bagCount]            -1 for the root
+ *   uint32     vertexOffsets[bagCount + 1]  vertices of bag b are vertices[vertexOffsets[b], vertexOffsets[b + 1])
+ *   int32      vertices[vertexCount]
+ *   uint32     edgeOffsets[bagCount + 1]    same for the introduce-edges
+ *   int32      edges[2 * edgeCount]         (u, v) pairs
+ *   uint8      types[bagCount]              'f', 'i', 'j' or 'l'
+ */
+
+/**
+ * Identifies the graph of a nice-TD, so that a cache file of another graph is rejected: the numbers of vertices and
+ * edges and the sum (mod 2^64) of the splitmix64 hashes of its edges as (min << 32) | max, which does not depend on
+ * the order of the edges. read.py computes the same.
+ */
+struct GraphFingerprint
+{
+    std::uint64_t vertexCount = 0;
+    std::uint64_t edgeCount = 0;
+    std::uint64_t edgeHash = 0;
+
+    bool operator==(const GraphFingerprint& other) const
+    {
+        return vertexCount == other.vertexCount && edgeCount == other.edgeCount && edgeHash == other.edgeHash;
+    }
+};
+
+inline GraphFingerprint fingerprintOf(const Graph& graph)
+{
+    GraphFingerprint fingerprint{ static_cast<std::uint64_t>(graph.vertexCount), graph.edges.size(), 0 };
+    for (const auto &[u, v] : graph.edges)
+    {
+        auto key = ((static_cast<std::uint64_t>(std::min(u, v)) << 32) | static_cast<std::uint64_t>(std::max(u, v))) +
+            0x9e3779b97f4a7c15;
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111eb;
+        fingerprint.edgeHash += key ^ (key >> 31);
+    }
+    return fingerprint;
+}
+
+namespace niceTdCache
+{
+
+constexpr char magic[4] = { 'N', 'T', 'D', '\0' };
+constexpr std::uint32_t version = 2;
+
+struct Header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t bagCount;
+    std::uint64_t vertexCount;
+    std::uint64_t edgeCount;
+    GraphFingerprint graph;
+};
+static_assert(sizeof(Header) == 56, "cache header must match read.py");
+
+// the size of a file with this header, nothing if the counts cannot belong to a file of 'size' bytes
+inline std::optional<std::uint64_t> fileSize(const Header& header, std::uint64_t size)
+{
+    // every entry takes at least a byte, so larger counts are corrupt and smaller ones cannot overflow the sum
+    if (header.bagCount > size || header.vertexCount > size || header.edgeCount > size)
+    {
+        return std::nullopt;
+    }
+    return sizeof(Header) + 4 * (header.bagCount + (header.bagCount + 1) + header.vertexCount + (header.bagCount + 1) +
+        2 * header.edgeCount) + header.bagCount;
+}
+
+// read-only mapping of a whole file, unmapped on destruction
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+    {
+        const auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not open " + path);
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Could not stat " + path);
+        }
+        size = static_cast<std::size_t>(status.st_size);
+        if (size > 0)
+        {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            data = nullptr;
+            throw std::runtime_error("Could not map " + path);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        if (data != nullptr)
+        {
+            ::munmap(data, size);
+        }
+    }
+
+    const unsigned char* bytes() const
+    {
+        return static_cast<const unsigned char*>(data);
+    }
+
+    std::size_t size = 0;
+
+private:
+    void* data = nullptr;
+};
+
+// a contiguous array of a mapped file
+template<typename T>
+class ArrayView
+{
+public:
+    ArrayView(const T* first, const T* last) : first(first), last(last)
+    {
+    }
+
+    const T* begin() const
+    {
+        return first;
+    }
+
+    const T* end() const
+    {
+        return last;
+    }
+
+    const T* cbegin() const
+    {
+        return first;
+    }
+
+    const T* cend() const
+    {
+        return last;
+    }
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(last - first);
+    }
+
+    bool empty() const
+    {
+        return first == last;
+    }
+
+    const T& operator[](std::size_t i) const
+    {
+        return first[i];
+    }
+
+private:
+    const T* first;
+    const T* last;
+};
+
+// the (u, v) edges of a mapped array of 2 * size int32s
+class EdgeView
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<int, int>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        explicit Iterator(const std::int32_t* position) : position(position)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return { position[0], position[1] };
+        }
+
+        Iterator& operator++()
+        {
+            position += 2;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto previous = *this;
+            position += 2;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return position == other.position;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return position != other.position;
+        }
+
+    private:
+        const std::int32_t* position;
+    };
+
+    EdgeView(const std::int32_t* first, const std::int32_t* last) : first(first), last(last)
+    {
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(first);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(last);
+    }
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(last - first) / 2;
+    }
+
+    bool empty() const
+    {
+        return first == last;
+    }
+
+private:
+    const std::int32_t* first;
+    const std::int32_t* last;
+};
+
+} // namespace niceTdCache
+
+// one bag of a MappedNiceTD, as NiceBag but with views into the mapping
+struct MappedNiceBag
+{
+    BagType type;
+    std::optional<std::size_t> parent;
+    niceTdCache::ArrayView<std::int32_t> vertices;
+    niceTdCache::EdgeView introduceEdges;
+};
+
+/**
+ * A nice-TD in the cache format, used in place of the mapped file: the bags are views into the mapping, so the DP
+ * (minDominatingSet takes it like a std::vector<NiceBag>) builds its bags from the file without an intermediate copy.
+ * The header, the offsets and the types are checked such that a truncated or foreign file raises std::runtime_error
+ * instead of reading out of bounds, and so is a file of a graph with another fingerprint.
+ */
+class MappedNiceTD
+{
+public:
+    MappedNiceTD(const std::string& path, const GraphFingerprint& graph) :
+        file(std::make_unique<niceTdCache::MappedFile>(path))
+    {
+        niceTdCache::Header header;
+        if (file->size < sizeof(header))
+        {
+            throw std::runtime_error("Invalid nice-TD cache (too short): " + path);
+        }
+        std::memcpy(&header, file->bytes(), sizeof(header));
+        const auto expectedSize = niceTdCache::fileSize(header, file->size);
+        if (std::memcmp(header.magic, niceTdCache::magic, sizeof(header.magic)) != 0 ||
+            header.version != niceTdCache::version || header.bagCount == 0 || !expectedSize.has_value() ||
+            expectedSize.value() != file->size)
+        {
+            throw std::runtime_error("Invalid nice-TD cache (wrong header or size): " + path);
+        }
+        if (!(header.graph == graph))
+        {
+            throw std::runtime_error("The nice-TD cache " + path + " belongs to another graph");
+        }
+
+        bagCount = header.bagCount;
+        parents = reinterpret_cast<const std::int32_t*>(file->bytes() + sizeof(header));
+        vertexOffsets = reinterpret_cast<const std::uint32_t*>(parents + bagCount);
+        vertices = reinterpret_cast<const std::int32_t*>(vertexOffsets + bagCount + 1);
+        edgeOffsets = reinterpret_cast<const std::uint32_t*>(vertices + header.vertexCount);
+        edges = reinterpret_cast<const std::int32_t*>(edgeOffsets + bagCount + 1);
+        types = reinterpret_cast<const unsigned char*>(edges + 2 * header.edgeCount);
+        if (vertexOffsets[0] != 0 || vertexOffsets[bagCount] != header.vertexCount || edgeOffsets[0] != 0 ||
+            edgeOffsets[bagCount] != header.edgeCount)
+        {
+            throw std::runtime_error("Invalid nice-TD cache (offsets): " + path);
+        }
+        for (std::size_t b = 0; b < bagCount; ++b)
+        {
+            if (vertexOffsets[b] > vertexOffsets[b + 1] || edgeOffsets[b] > edgeOffsets[b + 1] ||
+                (types[b] != 'f' && types[b] != 'i' && types[b] != 'j' && types[b] != 'l') ||
+                parents[b] < -1 || parents[b] >= static_cast<std::int64_t>(bagCount))
+            {
+                throw std::runtime_error("Invalid nice-TD cache (bag " + std::to_string(b) + "): " + path);
+            }
+        }
+    }
+
+    std::size_t size() const
+    {
+        return bagCount;
+    }
+
+    bool empty() const
+    {
+        return bagCount == 0;
+    }
+
+    MappedNiceBag operator[](std::size_t b) const
+    {
+        return { static_cast<BagType>(types[b]),
+            parents[b] >= 0 ? std::make_optional(static_cast<std::size_t>(parents[b])) : std::nullopt,
+            { vertices + vertexOffsets[b], vertices + vertexOffsets[b + 1] },
+            { edges + 2 * std::size_t{ edgeOffsets[b] }, edges + 2 * std::size_t{ edgeOffsets[b + 1] } } };
+    }
+
+    MappedNiceBag front() const
+    {
+        return (*this)[0];
+    }
+
+    // a copy of the bags, for the users of std::vector<NiceBag>
+    std::vector<NiceBag> niceBags() const
+    {
+        std::vector<NiceBag> copy;
+        copy.reserve(bagCount);
+        for (std::size_t b = 0; b < bagCount; ++b)
+        {
+            const auto bag = (*this)[b];
+            copy.push_back({ bag.type, bag.parent, std::vector<int>(bag.vertices.begin(), bag.vertices.end()),
+                std::vector<std::pair<int, int>>(bag.introduceEdges.begin(), bag.introduceEdges.end()) });
+        }
+        return copy;
+    }
+
+private:
+    std::unique_ptr<niceTdCache::MappedFile> file;
+    std::size_t bagCount = 0;
+    const std::int32_t* parents = nullptr;
+    const std::uint32_t* vertexOffsets = nullptr;
+    const std::int32_t* vertices = nullptr;
+    const std::uint32_t* edgeOffsets = nullptr;
+    const std::int32_t* edges = nullptr;
+    const unsigned char* types = nullptr;
+};
+
+// loads a nice-TD of 'graph' written in the cache format as a copy, see MappedNiceTD
+inline std::vector<NiceBag> loadNiceTDCache(const std::string& path, const GraphFingerprint& graph)
+{
+    return MappedNiceTD(path, graph).niceBags();
+}
+
+// writes the nice-TD 'niceBags' of 'graph' in the cache format, throws std::runtime_error if the file cannot be written
+inline void writeNiceTDCache(const std::string& path, const std::vector<NiceBag>& niceBags, const GraphFingerprint& graph)
+{
+    niceTdCache::Header header{};
+    std::memcpy(header.magic, niceTdCache::magic, sizeof(header.magic));
+    header.version = niceTdCache::version;
+    header.bagCount = niceBags.size();
+    header.graph = graph;
+
+    std::vector<std::int32_t> parents, vertices, edges;
+    std::vector<std::uint32_t> vertexOffsets{ 0 }, edgeOffsets{ 0 };
+    std::vector<unsigned char> types;
+    for (const auto &bag : niceBags)
+    {
+        parents.push_back(bag.parent.has_value() ? static_cast<std::int32_t>(bag.parent.value()) : -1);
+        vertices.insert(vertices.end(), bag.vertices.begin(), bag.vertices.end());
+        vertexOffsets.push_back(static_cast<std::uint32_t>(vertices.size()));
+        for (const auto &[u, v] : bag.introduceEdges)
+        {
+            edges.push_back(u);
+            edges.push_back(v);
+        }
+        edgeOffsets.push_back(static_cast<std::uint32_t>(edges.size() / 2));
+        types.push_back(static_cast<unsigned char>(bag.type));
+    }
+    header.vertexCount = vertices.size();
+    header.edgeCount = edges.size() / 2;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const auto write = [&out](const auto& array)
+    {
+        out.write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(array[0]));
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write(parents);
+    write(vertexOffsets);
+    write(vertices);
+    write(edgeOffsets);
+    write(edges);
+    write(types);
+    if (!out)
+    {
+        throw std::runtime_error("Could not write nice-TD cache " + path);
+    }
+}
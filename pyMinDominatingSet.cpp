@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "incrementalDominatingSet.hpp"
+#include "minDominatingSet.hpp"
+
+namespace py = pybind11;
+
+namespace
+{
+
+// the labelled nice-TD of the python arguments, one entry per bag
+std::vector<NiceBag> niceBagsOf(const std::vector<std::string>& types, const std::vector<std::optional<std::size_t>>& parents,
+    const std::vector<std::vector<int>>& vertices, const std::vector<std::vector<std::pair<int, int>>>& introduceEdges)
+{
+    if (parents.size() != types.size() || vertices.size() != types.size() || introduceEdges.size() != types.size())
+    {
+        throw std::invalid_argument("types, parents, vertices and introduce_edges must have the same length");
+    }
+    std::vector<NiceBag> niceBags;
+    niceBags.reserve(types.size());
+    for (std::size_t number = 0; number < types.size(); ++number)
+    {
+        // sage labels bags with 'forget', 'intro', 'join' and 'leaf', the first letter is the BagType
+        const auto &type = types[number];
+        if (type.empty() || (type[0] != 'f' && type[0] != 'i' && type[0] != 'j' && type[0] != 'l'))
+        {
+            throw std::invalid_argument("unknown bag type: " + type);
+        }
+        niceBags.push_back({ static_cast<BagType>(type[0]), parents[number], vertices[number], introduceEdges[number] });
+    }
+    return niceBags;
+}
+
+// the weights of the python argument indexed by vertex id (see minDominatingSet), vertices without one weigh 1
+std::vector<std::uint32_t> weightsOf(const std::map<int, std::uint32_t>& vertexWeights, const std::vector<NiceBag>& niceBags)
+{
+    if (vertexWeights.empty())
+    {
+        return {};
+    }
+    int largestVertex = 0;
+    for (const auto &bag : niceBags)
+    {
+        for (const auto vertex : bag.vertices)
+        {
+            largestVertex = std::max(largestVertex, vertex);
+        }
+    }
+    std::vector<std::uint32_t> weights(static_cast<std::size_t>(largestVertex) + 1, 1);
+    for (const auto &[vertex, weight] : vertexWeights)
+    {
+        if (vertex >= 0 && vertex <= largestVertex)
+        {
+            weights[static_cast<std::size_t>(vertex)] = weight;
+        }
+    }
+    return weights;
+}
+
+} // namespace
+
+/**
+ * Python bindings of the DP (module 'mindomset'), so read.py/sage can hand over a labelled nice-TD in-process
+ * instead of serializing it into a temp file and starting the executable.
+ */
+PYBIND11_MODULE(mindomset, m)
+{
+    m.doc() = "Minimum dominating set via dynamic programming on nice tree-decompositions";
+
+    m.def("solve",
+        [](const std::vector<std::string>& types, const std::vector<std::optional<std::size_t>>& parents,
+            const std::vector<std::vector<int>>& vertices, const std::vector<std::vector<std::pair<int, int>>>& introduceEdges,
+            std::size_t threads, bool witness, std::size_t checkpointInterval, bool prune,
+            const std::string& spillDir, const std::map<int, std::uint32_t>& vertexWeights) -> py::dict
+        {
+            const auto niceBags = niceBagsOf(types, parents, vertices, introduceEdges);
+            const auto weights = weightsOf(vertexWeights, niceBags);
+            DominatingSetResult result;
+            {
+                py::gil_scoped_release release;
+                result = minDominatingSet(niceBags, threads, { witness || checkpointInterval > 0, checkpointInterval },
+                    EngineChoice::Auto, prune, nullptr, spillDir, nullptr, weights);
+            }
+            py::dict ret;
+            ret["size"] = result.size;
+            ret["peak_table_bytes"] = result.peakTableBytes;
+            if (prune)
+            {
+                ret["upper_bound"] = result.upperBound;
+                ret["pruned_states"] = result.prunedStates;
+            }
+            if (witness || checkpointInterval > 0)
+            {
+                ret["dominating_set"] = result.dominatingSet;
+            }
+            return ret;
+        },
+        py::arg("types"), py::arg("parents"), py::arg("vertices"), py::arg("introduce_edges"), py::arg("threads") = 1,
+        py::arg("witness") = false, py::arg("checkpoint_interval") = 0, py::arg("prune") = false,
+        py::arg("spill_dir") = "", py::arg("weights") = std::map<int, std::uint32_t>(),
+        R"(Solves a labelled nice-TD given as one entry per bag (index = bag number, 0 is the empty root):
+the bag type ('forget', 'intro', 'join' or 'leaf'), the parent number (None for the root), the vertices
+and the edges introduced at the bag. Returns a dict with 'size' and 'peak_table_bytes', with 'witness' (or a
+'checkpoint_interval', see WitnessOptions) also with the vertices of a minimum dominating set in 'dominating_set'.
+'prune' bounds the tables by a greedy solution and adds 'upper_bound' and 'pruned_states'. With a 'spill_dir' the
+tables of pending join branches wait in files there. With 'weights' (a dict vertex -> non-negative int, missing
+vertices weigh 1) 'size' is the weight of a minimum weight dominating set.)");
+
+    py::class_<IncrementalDominatingSet>(m, "IncrementalDominatingSet",
+        R"(Solves a labelled nice-TD (same arguments as solve) and keeps all of its tables, so that update() re-solves
+after a few edges are added or removed by recomputing only the bags above the edited ones.)")
+        .def(py::init([](const std::vector<std::string>& types, const std::vector<std::optional<std::size_t>>& parents,
+                const std::vector<std::vector<int>>& vertices,
+                const std::vector<std::vector<std::pair<int, int>>>& introduceEdges, std::size_t threads)
+            {
+                const auto niceBags = niceBagsOf(types, parents, vertices, introduceEdges);
+                py::gil_scoped_release release;
+                return std::make_unique<IncrementalDominatingSet>(niceBags, threads);
+            }),
+            py::arg("types"), py::arg("parents"), py::arg("vertices"), py::arg("introduce_edges"), py::arg("threads") = 1)
+        .def_property_readonly("size", &IncrementalDominatingSet::size)
+        .def_property_readonly("table_bytes", &IncrementalDominatingSet::tableBytes)
+        .def("update", &IncrementalDominatingSet::update, py::arg("added") = std::vector<std::pair<int, int>>(),
+            py::arg("removed") = std::vector<std::pair<int, int>>(), py::call_guard<py::gil_scoped_release>(),
+            R"(Adds and removes edges (pairs of vertices that share a bag) and re-solves, returns the number of
+recomputed bags. Raises ValueError if an edge cannot be applied, the graph is then unchanged.)");
+}
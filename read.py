@@ -1,6 +1,8 @@
+import struct
 import sys
 from pathlib import Path
 from sage.all import *
+from array import array
 from sage.graphs.graph_decompositions.tree_decomposition import make_nice_tree_decomposition, label_nice_tree_decomposition, is_valid_tree_decomposition, width_of_tree_decomposition
 
 def gr_to_graph_library(path):
@@ -74,8 +76,65 @@ def read_td(path):
     TD = Graph(bag_edges)
     return TD
 
+def graph_fingerprint(graph_dict):
+    # GraphFingerprint of niceTdCache.hpp: vertices, edges and the sum of the splitmix64 hashes of the edges (mod 2^64)
+    mask = (1 << 64) - 1
+    edge_hash = 0
+    edge_count = 0
+    for u, neighbors in graph_dict.items():
+        for v in neighbors:
+            key = (((min(u, v) << 32) | max(u, v)) + 0x9e3779b97f4a7c15) & mask
+            key = ((key ^ (key >> 30)) * 0xbf58476d1ce4e5b9) & mask
+            key = ((key ^ (key >> 27)) * 0x94d049bb133111eb) & mask
+            edge_hash = (edge_hash + (key ^ (key >> 31))) & mask
+            edge_count += 1
+    return len(graph_dict), edge_count, edge_hash
+
+def write_nice_td_cache(path, labelled_nice_TD_G, sorted_labelled_nice_TD_G, introduceEdgeNodes, fingerprint):
+    # binary nice-TD format of niceTdCache.hpp (native byte order, 4-byte integers), mapped by the C++ side
+    types = bytearray()
+    parents = array("i")
+    vertexOffsets = array("I", [0])
+    vertices = array("i")
+    edgeOffsets = array("I", [0])
+    edges = array("i")
+    for node in sorted_labelled_nice_TD_G:
+        smaller = [int(neighbor[0]) for neighbor in labelled_nice_TD_G.neighbors(node) if neighbor[0] < node[0]]
+        types.append(ord(str(labelled_nice_TD_G.get_vertex(node))[0]))
+        parents.append(smaller[0] if smaller else -1)
+        vertices.extend(int(v) for v in node[1])
+        vertexOffsets.append(len(vertices))
+        for u, v in introduceEdgeNodes[node]:
+            edges.extend((int(u), int(v)))
+        edgeOffsets.append(len(edges) // 2)
+    assert parents.itemsize == 4 and vertexOffsets.itemsize == 4
+    with open(path, "wb") as f:
+        f.write(b"NTD\0" + struct.pack("=IQQQQQQ", 2, len(types), len(vertices), len(edges) // 2, *fingerprint))
+        for part in (parents, vertexOffsets, vertices, edgeOffsets, edges):
+            part.tofile(f)
+        f.write(types)
+
+def solve_in_process(labelled_nice_TD_G, sorted_labelled_nice_TD_G, introduceEdgeNodes, threads=1):
+    # hands the labelled nice TD to the C++ DP (module built from pyMinDominatingSet.cpp) without a temp file
+    import mindomset
+    types = []
+    parents = []
+    vertices = []
+    introduce_edges = []
+    for node in sorted_labelled_nice_TD_G:
+        # labels are given in BFS order, so the parent is the only neighbor with a smaller label
+        smaller = [int(neighbor[0]) for neighbor in labelled_nice_TD_G.neighbors(node) if neighbor[0] < node[0]]
+        types.append(str(labelled_nice_TD_G.get_vertex(node)))
+        parents.append(smaller[0] if smaller else None)
+        vertices.append([int(v) for v in node[1]])
+        introduce_edges.append([(int(u), int(v)) for u, v in introduceEdgeNodes[node]])
+    return mindomset.solve(types, parents, vertices, introduce_edges, threads)
+
 
 if __name__ == "__main__":
+    # '--solve' runs the DP in-process instead of printing/writing the nice TD
+    solve = "--solve" in sys.argv
+    sys.argv = [arg for arg in sys.argv if arg != "--solve"]
     if len(sys.argv) < 2:
         raise Exception("add path to .gr/.td file")
     input_gr = Path(sys.argv[1])
@@ -93,7 +152,8 @@ if __name__ == "__main__":
             outputFilePath = Path(sys.argv[2])
 
     if input_gr.suffix == ".gr":
-        G = Graph(gr_to_graph_library(input_gr))
+        G_dict = gr_to_graph_library(input_gr)
+        G = Graph(G_dict)
         if input_td is None:
             print("computing optimal TD (NP-hard) using sage...")
             # computing an optimal TD is an NP-complete problem and thus the complexity of the next line dwarfes every
@@ -128,7 +188,13 @@ if __name__ == "__main__":
     if edge_insert_count != G.num_edges():
         raise ValueError("wrong amount of edges are introduced")
     
-    if outputFilePath is None:
+    if solve:
+        result = solve_in_process(labelled_nice_TD_G, sorted_labelled_nice_TD_G, introduceEdgeNodes)
+        print("The size of the minimum-dominating-set in this graph is: ", result["size"])
+    elif outputFilePath is not None and outputFilePath.suffix == ".ntd":
+        write_nice_td_cache(outputFilePath, labelled_nice_TD_G, sorted_labelled_nice_TD_G, introduceEdgeNodes,
+                            graph_fingerprint(G_dict))
+    elif outputFilePath is None:
         for node in sorted_labelled_nice_TD_G:
             print("".join(str(node).split()), "".join(str(labelled_nice_TD_G.get_vertex(node)).split()), "".join(str(labelled_nice_TD_G.neighbors(node)).split()))
     else:
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "indexedTable.hpp"
+
+/**
+ * Sparse table engine: only the colorings with a finite value are stored, as base-3 indices (the same keys as in the
+ * dense tables) sorted ascending, with their values in a parallel array. Memory and time of the kernels scale with the
+ * number of feasible colorings instead of 3^k, which pays off for bags where most colorings are infinite (e.g. white
+ * vertices without a black neighbor in low-degree graphs).
+ * The kernels produce sorted output from sorted input with merges, only the join sorts (its candidate colorings).
+ */
+namespace sparse
+{
+
+using Key = std::uint32_t;
+using indexed::infinity;
+
+template<typename Value>
+struct Table
+{
+    std::vector<Key> keys;
+    std::vector<Value> values;
+
+    std::size_t size() const
+    {
+        return keys.size();
+    }
+
+    std::size_t bytes() const
+    {
+        return keys.capacity() * sizeof(Key) + values.capacity() * sizeof(Value);
+    }
+
+    void push(Key key, Value value)
+    {
+        keys.push_back(key);
+        values.push_back(value);
+    }
+
+    // value of a coloring, infinity if it is not stored
+    Value at(Key key) const
+    {
+        const auto it = std::lower_bound(keys.cbegin(), keys.cend(), key);
+        return (it != keys.cend() && *it == key) ? values[it - keys.cbegin()] : infinity<Value>;
+    }
+};
+
+template<typename Value>
+Table<Value> fromDense(const indexed::Table<Value>& dense)
+{
+    Table<Value> table;
+    for (std::size_t index = 0; index < dense.size(); ++index)
+    {
+        if (dense[index] != infinity<Value>)
+        {
+            table.push(static_cast<Key>(index), dense[index]);
+        }
+    }
+    return table;
+}
+
+template<typename Value>
+void toDense(indexed::Table<Value>& dense, const Table<Value>& table)
+{
+    std::fill(dense.begin(), dense.end(), infinity<Value>);
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        dense[table.keys[i]] = table.values[i];
+    }
+}
+
+/**
+ * Introduces the vertex at 'position': every child coloring becomes a black (+cost, see indexed::UnitCost) and a grey
+ * one, white ones are infinite and not stored. Within a block of the digits above 'position' all black keys are below
+ * the grey keys.
+ */
+template<typename Value, typename Cost = indexed::UnitCost>
+void introduceVertex(Table<Value>& table, const Table<Value>& childTable, std::size_t position, const Cost& cost = {})
+{
+    const auto low = static_cast<Key>(indexed::pow3(position));
+    const auto blackCost = static_cast<Value>(cost[position]);
+    table.keys.reserve(2 * childTable.size());
+    table.values.reserve(2 * childTable.size());
+    for (std::size_t begin = 0; begin < childTable.size();)
+    {
+        const auto hi = childTable.keys[begin] / low;
+        auto end = begin;
+        while (end < childTable.size() && childTable.keys[end] / low == hi)
+        {
+            ++end;
+        }
+        for (const auto color : { Color::Black, Color::Grey })
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto value = childTable.values[i];
+                table.push(hi * 3 * low + static_cast<Key>(color) * low + childTable.keys[i] % low,
+                    color == Color::Black ? static_cast<Value>(value + blackCost) : value);
+            }
+        }
+        begin = end;
+    }
+}
+
+/**
+ * indexed::dominateVertex: the white colorings of an introduced vertex at 'position' that is dominated already take
+ * the values of the grey ones. Within a block of the digits above, the copies go before the black keys.
+ */
+template<typename Value>
+void dominateVertex(Table<Value>& table, std::size_t position)
+{
+    const auto low = static_cast<Key>(indexed::pow3(position));
+    constexpr auto whiteToGrey = static_cast<Key>(Color::Grey) - static_cast<Key>(Color::White);
+    Table<Value> dominated;
+    dominated.keys.reserve(table.size() + table.size() / 2);
+    dominated.values.reserve(table.size() + table.size() / 2);
+    for (std::size_t begin = 0; begin < table.size();)
+    {
+        const auto hi = table.keys[begin] / (3 * low);
+        auto end = begin;
+        while (end < table.size() && table.keys[end] / (3 * low) == hi)
+        {
+            ++end;
+        }
+        for (auto i = begin; i < end; ++i)
+        {
+            if (static_cast<Color>((table.keys[i] / low) % 3) == Color::Grey)
+            {
+                dominated.push(table.keys[i] - whiteToGrey * low, table.values[i]);
+            }
+        }
+        for (auto i = begin; i < end; ++i)
+        {
+            dominated.push(table.keys[i], table.values[i]);
+        }
+        begin = end;
+    }
+    table = std::move(dominated);
+}
+
+/**
+ * Forgets the vertex at 'position' of the child bag: the white and the black colorings of a block are merged on the
+ * remaining digits, taking the min where both exist. Grey colorings are dropped.
+ */
+template<typename Value>
+void forgetVertex(Table<Value>& table, const Table<Value>& childTable, std::size_t position)
+{
+    const auto low = static_cast<Key>(indexed::pow3(position));
+    const auto digit = [low](Key key) { return static_cast<Color>((key / low) % 3); };
+    for (std::size_t begin = 0; begin < childTable.size();)
+    {
+        const auto hi = childTable.keys[begin] / (3 * low);
+        auto white = begin;
+        auto black = begin;
+        while (black < childTable.size() && childTable.keys[black] / (3 * low) == hi && digit(childTable.keys[black]) == Color::White)
+        {
+            ++black;
+        }
+        const auto whiteEnd = black;
+        auto blackEnd = black;
+        while (blackEnd < childTable.size() && childTable.keys[blackEnd] / (3 * low) == hi && digit(childTable.keys[blackEnd]) == Color::Black)
+        {
+            ++blackEnd;
+        }
+        while (white < whiteEnd || black < blackEnd)
+        {
+            const auto whiteLo = white < whiteEnd ? childTable.keys[white] % low : low;
+            const auto blackLo = black < blackEnd ? childTable.keys[black] % low : low;
+            const auto lo = std::min(whiteLo, blackLo);
+            const auto whiteValue = whiteLo == lo ? childTable.values[white++] : infinity<Value>;
+            const auto blackValue = blackLo == lo ? childTable.values[black++] : infinity<Value>;
+            table.push(hi * low + lo, std::min(whiteValue, blackValue));
+        }
+        // skip the grey block
+        begin = blackEnd;
+        while (begin < childTable.size() && childTable.keys[begin] / (3 * low) == hi)
+        {
+            ++begin;
+        }
+    }
+}
+
+// merges two tables with disjoint keys
+template<typename Value>
+Table<Value> mergeDisjoint(const Table<Value>& a, const Table<Value>& b)
+{
+    Table<Value> table;
+    table.keys.reserve(a.size() + b.size());
+    table.values.reserve(a.size() + b.size());
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < a.size() || j < b.size())
+    {
+        if (j == b.size() || (i < a.size() && a.keys[i] < b.keys[j]))
+        {
+            table.push(a.keys[i], a.values[i]);
+            ++i;
+        }
+        else
+        {
+            assert(i == a.size() || a.keys[i] != b.keys[j]);
+            table.push(b.keys[j], b.values[j]);
+            ++j;
+        }
+    }
+    return table;
+}
+
+/**
+ * Introduces the edge between the vertices at positions u and v: a white vertex with a black neighbor takes the value
+ * of its grey coloring, also if it was infinite before. So the white/black colorings are replaced by copies of the
+ * grey/black ones, each copy is a fixed offset below its original, which keeps both sets of copies sorted.
+ */
+template<typename Value>
+void introduceEdge(Table<Value>& table, std::size_t u, std::size_t v)
+{
+    const auto uWeight = static_cast<Key>(indexed::pow3(u));
+    const auto vWeight = static_cast<Key>(indexed::pow3(v));
+    constexpr auto whiteToGrey = static_cast<Key>(Color::Grey) - static_cast<Key>(Color::White);
+    Table<Value> kept;
+    Table<Value> vDominated;
+    Table<Value> uDominated;
+    kept.keys.reserve(table.size());
+    kept.values.reserve(table.size());
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        const auto key = table.keys[i];
+        const auto uColor = static_cast<Color>((key / uWeight) % 3);
+        const auto vColor = static_cast<Color>((key / vWeight) % 3);
+        if (uColor == Color::Black && vColor == Color::Grey)
+        {
+            vDominated.push(key - whiteToGrey * vWeight, table.values[i]);
+        }
+        else if (uColor == Color::Grey && vColor == Color::Black)
+        {
+            uDominated.push(key - whiteToGrey * uWeight, table.values[i]);
+        }
+        if (!(uColor == Color::Black && vColor == Color::White) && !(uColor == Color::White && vColor == Color::Black))
+        {
+            kept.push(key, table.values[i]);
+        }
+    }
+    table = mergeDisjoint(mergeDisjoint(kept, vDominated), uDominated);
+}
+
+// drops all entries above 'limit', returns how many were dropped
+template<typename Value>
+std::size_t prune(Table<Value>& table, Value limit)
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        if (table.values[i] <= limit)
+        {
+            table.keys[kept] = table.keys[i];
+            table.values[kept] = table.values[i];
+            ++kept;
+        }
+    }
+    const auto pruned = table.size() - kept;
+    table.keys.resize(kept);
+    table.values.resize(kept);
+    return pruned;
+}
+
+namespace detail
+{
+
+// black and white positions of a stored coloring, as bitmasks ('whiteWeight' is the sum of 3^i over the white ones)
+struct Split
+{
+    std::uint32_t black;
+    std::uint32_t white;
+    Key whiteWeight;
+    std::uint32_t blackCost;
+    std::size_t entry;
+};
+
+// splits of all entries of 'table', ordered by their black positions
+template<typename Value, typename Cost>
+std::vector<Split> splitByBlack(const Table<Value>& table, std::size_t bagSize, const Cost& cost)
+{
+    std::vector<Split> splits;
+    splits.reserve(table.size());
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        Split split{ 0, 0, 0, 0, i };
+        auto key = table.keys[i];
+        Key weight = 1;
+        for (std::size_t position = 0; position < bagSize; ++position, key /= 3, weight *= 3)
+        {
+            const auto color = static_cast<Color>(key % 3);
+            if (color == Color::Black)
+            {
+                split.black |= std::uint32_t{ 1 } << position;
+                split.blackCost += cost[position];
+            }
+            else if (color == Color::White)
+            {
+                split.white |= std::uint32_t{ 1 } << position;
+                split.whiteWeight += weight;
+            }
+        }
+        splits.push_back(split);
+    }
+    std::stable_sort(splits.begin(), splits.end(), [](const Split& a, const Split& b) { return a.black < b.black; });
+    return splits;
+}
+
+} // namespace detail
+
+/**
+ * Joins two tables over the same bag. Consistent pairs of child colorings have the same black vertices and no common
+ * white vertex (the white vertices of the parent are dominated in exactly one subtree, grey in the other), so the
+ * entries of both children are grouped by their black vertices and only pairs within a group are combined. Every pair
+ * yields the coloring of the first child with the white vertices of the second one (grey in the first) set to white,
+ * the candidates are sorted and reduced to their min.
+ */
+template<typename Value, typename Cost = indexed::UnitCost>
+void join(Table<Value>& table, const Table<Value>& childTable1, const Table<Value>& childTable2, std::size_t bagSize,
+    const Cost& cost = {})
+{
+    constexpr auto whiteToGrey = static_cast<Key>(Color::Grey) - static_cast<Key>(Color::White);
+    const auto splits1 = detail::splitByBlack(childTable1, bagSize, cost);
+    const auto splits2 = detail::splitByBlack(childTable2, bagSize, cost);
+    std::vector<std::pair<Key, Value>> candidates;
+    for (std::size_t i = 0, j = 0; i < splits1.size() && j < splits2.size();)
+    {
+        if (splits1[i].black != splits2[j].black)
+        {
+            (splits1[i].black < splits2[j].black ? i : j)++;
+            continue;
+        }
+        auto iEnd = i;
+        while (iEnd < splits1.size() && splits1[iEnd].black == splits1[i].black)
+        {
+            ++iEnd;
+        }
+        auto jEnd = j;
+        while (jEnd < splits2.size() && splits2[jEnd].black == splits2[j].black)
+        {
+            ++jEnd;
+        }
+        for (auto a = i; a < iEnd; ++a)
+        {
+            const auto key = childTable1.keys[splits1[a].entry];
+            // black vertices are counted in both children, a value is at least the cost of its black vertices
+            const auto value = childTable1.values[splits1[a].entry] - splits1[a].blackCost;
+            for (auto b = j; b < jEnd; ++b)
+            {
+                if ((splits1[a].white & splits2[b].white) == 0)
+                {
+                    candidates.emplace_back(key - whiteToGrey * splits2[b].whiteWeight,
+                        static_cast<Value>(value + childTable2.values[splits2[b].entry]));
+                }
+            }
+        }
+        i = iEnd;
+        j = jEnd;
+    }
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto &[key, value] : candidates)
+    {
+        // sorted by value within a key, so the first one is the min
+        if (table.size() == 0 || table.keys.back() != key)
+        {
+            table.push(key, value);
+        }
+    }
+}
+
+} // namespace sparse
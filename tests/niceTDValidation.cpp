@@ -0,0 +1,105 @@
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../minDominatingSet.hpp"
+
+/**
+ * Malformed nice-TDs have to be rejected by minDominatingSet with std::invalid_argument instead of crashing or
+ * returning a wrong size, this is the path that the python module exposes.
+ * Build and run: g++ -O1 -g -std=c++17 -pthread -fsanitize=address,undefined tests/niceTDValidation.cpp -o niceTDValidation
+ * && ./niceTDValidation
+ */
+
+namespace
+{
+
+// the star with center 1 and leaves 2 and 3, both edges in their own branch of the join at bag 1
+std::vector<NiceBag> star()
+{
+    return {
+        { BagType::Forget, std::nullopt, {}, {} },
+        { BagType::Join, 0, { 1 }, {} },
+        { BagType::Forget, 1, { 1 }, {} },
+        { BagType::Forget, 1, { 1 }, {} },
+        { BagType::Intro, 2, { 1, 2 }, { { 1, 2 } } },
+        { BagType::Intro, 3, { 1, 3 }, { { 1, 3 } } },
+        { BagType::Intro, 4, { 1 }, {} },
+        { BagType::Intro, 5, { 1 }, {} },
+        { BagType::Leaf, 6, {}, {} },
+        { BagType::Leaf, 7, {}, {} },
+    };
+}
+
+int failures = 0;
+
+void expectInvalid(const std::string& name, const std::function<void(std::vector<NiceBag>&)>& breakTD)
+{
+    auto niceBags = star();
+    breakTD(niceBags);
+    try
+    {
+        const auto result = minDominatingSet(niceBags);
+        std::cerr << name << ": accepted with size " << result.size << std::endl;
+        failures++;
+    }
+    catch (const std::invalid_argument&)
+    {
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const auto size = minDominatingSet(star()).size;
+    if (size != 1)
+    {
+        std::cerr << "star: size " << size << " instead of 1" << std::endl;
+        failures++;
+    }
+
+    // children per type
+    expectInvalid("leaf with a child", [](auto& niceBags) { niceBags[6] = { BagType::Leaf, 4, {}, {} }; });
+    expectInvalid("intro without a child", [](auto& niceBags) { niceBags[8] = { BagType::Intro, 6, { 1 }, {} }; });
+    expectInvalid("forget with two children", [](auto& niceBags) { niceBags[3].parent = 2; });
+    expectInvalid("join with one child", [](auto& niceBags)
+    {
+        niceBags = { { BagType::Forget, std::nullopt, {}, {} }, { BagType::Join, 0, { 1 }, {} },
+            { BagType::Intro, 1, { 1 }, {} }, { BagType::Leaf, 2, {}, {} } };
+    });
+    expectInvalid("root with two children", [](auto& niceBags)
+    {
+        niceBags.push_back({ BagType::Intro, 0, { 4 }, {} });
+        niceBags.push_back({ BagType::Leaf, 10, {}, {} });
+    });
+
+    // introduce and forget bags change exactly one vertex, in their direction
+    expectInvalid("intro of no vertex", [](auto& niceBags) { niceBags[4] = { BagType::Intro, 2, { 1 }, {} }; });
+    expectInvalid("intro of many vertices", [](auto& niceBags)
+    {
+        niceBags[4].vertices = { 1, 2, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+        niceBags[2].type = BagType::Intro;
+    });
+    expectInvalid("forget that introduces", [](auto& niceBags) { niceBags[2].type = BagType::Intro; });
+    expectInvalid("intro that forgets", [](auto& niceBags) { niceBags[6].type = BagType::Forget; });
+
+    // joins have the vertices of both children
+    expectInvalid("join of different children", [](auto& niceBags) { niceBags[3].vertices = { 3 }; });
+
+    // vertices and edges of a bag
+    expectInvalid("duplicate vertex", [](auto& niceBags) { niceBags[4].vertices = { 1, 2, 2 }; });
+    expectInvalid("edge to a vertex of another bag", [](auto& niceBags) { niceBags[4].introduceEdges = { { 1, 3 } }; });
+    expectInvalid("edge to a vertex in no bag", [](auto& niceBags) { niceBags[4].introduceEdges = { { 1, 7 } }; });
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " malformed nice-TDs were accepted" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "all malformed nice-TDs were rejected" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,689 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Native replacement for the parts of read.py that do not need sage: reading .gr and .td files (PACE format),
+ * checking the TD, building a labelled nice-tree-decomposition and assigning the introduce-edges to its bags.
+ * Errors are reported as std::runtime_error with the same messages as the python script.
+ */
+
+enum class BagType : char
+{
+    Forget = 'f', Intro = 'i', Join = 'j', Leaf = 'l'
+};
+
+struct Graph
+{
+    int vertexCount = 0;
+    // vertices are numbered 1..vertexCount as in the .gr file, adjacency[0] stays empty
+    std::vector<std::vector<int>> adjacency;
+    std::vector<std::pair<int, int>> edges;
+};
+
+struct TreeDecomposition
+{
+    // bags are numbered 1..bags.size()-1 as in the .td file, bags[0] stays empty
+    std::vector<std::vector<int>> bags;
+    std::vector<std::pair<int, int>> edges;
+};
+
+// one bag of a labelled nice TD: the number of a bag is its index, the root is number 0 and parents have
+// smaller numbers than their children
+struct NiceBag
+{
+    BagType type;
+    std::optional<std::size_t> parent;
+    std::vector<int> vertices;
+    std::vector<std::pair<int, int>> introduceEdges;
+};
+
+namespace detail
+{
+
+// splits a line into words, returns an empty vector for empty and comment lines
+inline std::vector<std::string> wordsOf(const std::string& line)
+{
+    std::istringstream strstr(line);
+    std::vector<std::string> words;
+    std::string word;
+    while (strstr >> word)
+    {
+        words.push_back(word);
+    }
+    if (!words.empty() && words.front()[0] == 'c')
+    {
+        words.clear();
+    }
+    return words;
+}
+
+inline int toInt(const std::string& word, const char* error)
+{
+    std::size_t length = 0;
+    int value = 0;
+    try
+    {
+        value = std::stoi(word, &length);
+    }
+    catch (const std::exception&)
+    {
+        throw std::runtime_error(error);
+    }
+    if (length != word.size())
+    {
+        throw std::runtime_error(error);
+    }
+    return value;
+}
+
+} // namespace detail
+
+inline Graph readGraph(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        throw std::runtime_error("Could not open " + path);
+    }
+    Graph graph;
+    std::optional<std::size_t> remainingEdges;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const auto words = detail::wordsOf(line);
+        if (words.empty())
+        {
+            continue;
+        }
+        if (words.front() == "p")
+        {
+            if (remainingEdges.has_value())
+            {
+                throw std::runtime_error("This is not a valid .gr file: more than 1 line starting with 'p'");
+            }
+            if (words.size() != 4 || words[1] != "tw")
+            {
+                throw std::runtime_error("This is not a valid .gr file");
+            }
+            graph.vertexCount = detail::toInt(words[2], "This is not a valid .gr file");
+            remainingEdges = detail::toInt(words[3], "This is not a valid .gr file");
+            graph.adjacency.resize(graph.vertexCount + 1);
+        }
+        else
+        {
+            if (!remainingEdges.has_value())
+            {
+                throw std::runtime_error("This is not a valid .gr file: first non-comment line must start with 'p'");
+            }
+            if (words.size() != 2)
+            {
+                throw std::runtime_error(".gr file is wrongly formatted");
+            }
+            const auto u = detail::toInt(words[0], ".gr file is wrongly formatted");
+            const auto v = detail::toInt(words[1], ".gr file is wrongly formatted");
+            if (u < 1 || v < 1 || u > graph.vertexCount || v > graph.vertexCount || u == v ||
+                std::find(graph.adjacency[u].cbegin(), graph.adjacency[u].cend(), v) != graph.adjacency[u].cend())
+            {
+                throw std::runtime_error(".gr file is wrongly formatted");
+            }
+            graph.adjacency[u].push_back(v);
+            graph.adjacency[v].push_back(u);
+            graph.edges.emplace_back(u, v);
+            if (remainingEdges.value() == 0)
+            {
+                throw std::runtime_error("This is not a valid .gr file: wrong amount of edges");
+            }
+            remainingEdges = remainingEdges.value() - 1;
+        }
+    }
+    if (remainingEdges.value_or(1) != 0)
+    {
+        throw std::runtime_error("This is not a valid .gr file: wrong amount of edges");
+    }
+    return graph;
+}
+
+inline TreeDecomposition readTreeDecomposition(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        throw std::runtime_error("Could not open " + path);
+    }
+    TreeDecomposition td;
+    bool firstLine = false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const auto words = detail::wordsOf(line);
+        if (words.empty())
+        {
+            continue;
+        }
+        if (words.front() == "s")
+        {
+            if (firstLine)
+            {
+                throw std::runtime_error("This is not a valid .td file: more than 1 line starting with 's'");
+            }
+            firstLine = true;
+            if (words.size() != 5 || words[1] != "td")
+            {
+                throw std::runtime_error("This is not a valid .td file: no 'td' word");
+            }
+            td.bags.resize(detail::toInt(words[2], "This is not a valid .td file") + 1);
+        }
+        else if (!firstLine)
+        {
+            throw std::runtime_error("This is not a valid .td file: the first non-comment line must start with 's'");
+        }
+        else if (words.front() == "b")
+        {
+            const auto bagId = words.size() > 1 ? detail::toInt(words[1], "This is not a valid .td file") : 0;
+            if (bagId < 1 || static_cast<std::size_t>(bagId) >= td.bags.size())
+            {
+                throw std::runtime_error("This is not a valid .td file: wrong bag number");
+            }
+            for (std::size_t i = 2; i < words.size(); ++i)
+            {
+                td.bags[bagId].push_back(detail::toInt(words[i], "This is not a valid .td file"));
+            }
+            std::sort(td.bags[bagId].begin(), td.bags[bagId].end());
+            td.bags[bagId].erase(std::unique(td.bags[bagId].begin(), td.bags[bagId].end()), td.bags[bagId].end());
+        }
+        else
+        {
+            if (words.size() != 2)
+            {
+                throw std::runtime_error("This is not a valid .td file");
+            }
+            const auto a = detail::toInt(words[0], "This is not a valid .td file");
+            const auto b = detail::toInt(words[1], "This is not a valid .td file");
+            if (a < 1 || b < 1 || static_cast<std::size_t>(a) >= td.bags.size() ||
+                static_cast<std::size_t>(b) >= td.bags.size())
+            {
+                throw std::runtime_error("This is not a valid .td file: wrong bag number");
+            }
+            td.edges.emplace_back(a, b);
+        }
+    }
+    return td;
+}
+
+namespace detail
+{
+
+// a TD rooted at one of its bags, 'order' lists the bags in BFS order (parents before children)
+struct RootedTreeDecomposition
+{
+    std::size_t root;
+    std::vector<std::optional<std::size_t>> parent;
+    std::vector<std::size_t> order;
+};
+
+inline std::vector<std::vector<std::size_t>> neighborsOf(const TreeDecomposition& td)
+{
+    std::vector<std::vector<std::size_t>> neighbors(td.bags.size());
+    for (const auto &[a, b] : td.edges)
+    {
+        neighbors[a].push_back(b);
+        neighbors[b].push_back(a);
+    }
+    return neighbors;
+}
+
+/**
+ * Roots 'td' at bag 'root' and checks that it is a valid tree-decomposition of 'graph' (like sage's
+ * is_valid_tree_decomposition), throws std::runtime_error otherwise.
+ */
+inline RootedTreeDecomposition rootTreeDecomposition(const Graph& graph, const TreeDecomposition& td, std::size_t root)
+{
+    const auto invalid = "The parsed .td file does not form a valid tree-decomposition for graph parsed from the .gr file";
+    if (graph.vertexCount == 0 || td.bags.size() < 2 || td.edges.size() != td.bags.size() - 2)
+    {
+        throw std::runtime_error(invalid);
+    }
+    const auto tdSize = td.bags.size() - 1;
+
+    const auto tdNeighbors = neighborsOf(td);
+    RootedTreeDecomposition rooted{ root, std::vector<std::optional<std::size_t>>(td.bags.size()), { root } };
+    std::vector<bool> visited(td.bags.size(), false);
+    visited[root] = true;
+    for (std::size_t i = 0; i < rooted.order.size(); ++i)
+    {
+        for (const auto neighbor : tdNeighbors[rooted.order[i]])
+        {
+            if (!visited[neighbor])
+            {
+                visited[neighbor] = true;
+                rooted.parent[neighbor] = rooted.order[i];
+                rooted.order.push_back(neighbor);
+            }
+        }
+    }
+    if (rooted.order.size() != tdSize)
+    {
+        throw std::runtime_error(invalid);
+    }
+
+    // the bags containing a vertex must form a non-empty subtree, i.e. exactly one of them has a parent without it
+    std::vector<int> tops(graph.vertexCount + 1, 0);
+    for (const auto bag : rooted.order)
+    {
+        for (const auto v : td.bags[bag])
+        {
+            if (v < 1 || v > graph.vertexCount)
+            {
+                throw std::runtime_error(invalid);
+            }
+            const auto &parent = rooted.parent[bag];
+            if (!parent.has_value() ||
+                !std::binary_search(td.bags[parent.value()].cbegin(), td.bags[parent.value()].cend(), v))
+            {
+                tops[v]++;
+            }
+        }
+    }
+    if (std::any_of(tops.cbegin() + 1, tops.cend(), [](int count) { return count != 1; }))
+    {
+        throw std::runtime_error(invalid);
+    }
+    return rooted;
+}
+
+inline std::vector<int> intersectionOf(const std::vector<int>& a, const std::vector<int>& b)
+{
+    std::vector<int> intersection;
+    std::set_intersection(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(intersection));
+    return intersection;
+}
+
+inline std::vector<int> unionOf(const std::vector<int>& a, const std::vector<int>& b)
+{
+    std::vector<int> unified;
+    std::set_union(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(unified));
+    return unified;
+}
+
+/**
+ * Builds the labelled nice-TD of a rooted (and checked) TD bottom-up, every TD bag becomes a nice bag with exactly
+ * its vertices. The branches of the children of a bag are joined either at the bag itself, or with 'joinAtUnions' at
+ * the union of the vertices they share with it (smallest first), so vertices only needed above the join are
+ * introduced after it. Forgets always come before introduces.
+ */
+inline std::vector<NiceBag> buildNiceTreeDecomposition(const Graph& graph, const TreeDecomposition& td,
+    const RootedTreeDecomposition& rooted, bool joinAtUnions)
+{
+    const auto invalid = "The parsed .td file does not form a valid tree-decomposition for graph parsed from the .gr file";
+    struct Node
+    {
+        std::vector<int> vertices;
+        std::vector<std::size_t> children;
+    };
+    std::vector<Node> nodes;
+    auto addNode = [&nodes](std::vector<int> vertices, std::vector<std::size_t> children) -> std::size_t
+    {
+        nodes.push_back({ std::move(vertices), std::move(children) });
+        return nodes.size() - 1;
+    };
+    // forgets the vertices of 'from' not in 'to', then introduces the ones of 'to' not in 'from'
+    auto transition = [&nodes, &addNode](std::size_t node, const std::vector<int>& to) -> std::size_t
+    {
+        auto current = nodes[node].vertices;
+        for (const auto v : std::vector<int>(nodes[node].vertices))
+        {
+            if (!std::binary_search(to.cbegin(), to.cend(), v))
+            {
+                current.erase(std::find(current.begin(), current.end(), v));
+                node = addNode(current, { node });
+            }
+        }
+        for (const auto v : to)
+        {
+            if (!std::binary_search(current.cbegin(), current.cend(), v))
+            {
+                current.insert(std::lower_bound(current.begin(), current.end(), v), v);
+                node = addNode(current, { node });
+            }
+        }
+        return node;
+    };
+
+    std::vector<std::size_t> topOf(td.bags.size());
+    std::vector<std::vector<std::size_t>> branches(td.bags.size());
+    for (auto it = rooted.order.crbegin(); it != rooted.order.crend(); ++it)
+    {
+        const auto bag = *it;
+        auto &bagBranches = branches[bag];
+        if (bagBranches.empty())
+        {
+            bagBranches.push_back(transition(addNode({}, {}), td.bags[bag]));
+        }
+        if (joinAtUnions)
+        {
+            std::stable_sort(bagBranches.begin(), bagBranches.end(), [&nodes](std::size_t a, std::size_t b)
+            {
+                return nodes[a].vertices.size() < nodes[b].vertices.size();
+            });
+            auto joined = bagBranches.front();
+            for (auto branch = bagBranches.cbegin() + 1; branch != bagBranches.cend(); ++branch)
+            {
+                const auto vertices = unionOf(nodes[joined].vertices, nodes[*branch].vertices);
+                const auto branch1 = transition(joined, vertices);
+                const auto branch2 = transition(*branch, vertices);
+                joined = addNode(vertices, { branch1, branch2 });
+            }
+            bagBranches = { transition(joined, td.bags[bag]) };
+        }
+        while (bagBranches.size() > 1)
+        {
+            const auto branch1 = bagBranches.back();
+            bagBranches.pop_back();
+            const auto branch2 = bagBranches.back();
+            bagBranches.pop_back();
+            bagBranches.push_back(addNode(td.bags[bag], { branch1, branch2 }));
+        }
+        topOf[bag] = bagBranches.front();
+        const auto &parent = rooted.parent[bag];
+        if (parent.has_value())
+        {
+            const auto &parentBag = td.bags[parent.value()];
+            branches[parent.value()].push_back(
+                transition(topOf[bag], joinAtUnions ? intersectionOf(td.bags[bag], parentBag) : parentBag));
+        }
+    }
+    const auto root = transition(topOf[rooted.root], {});
+
+    // label in BFS order from the root
+    std::vector<NiceBag> niceBags;
+    niceBags.reserve(nodes.size());
+    std::vector<std::size_t> labelled{ root };
+    std::vector<std::optional<std::size_t>> parentOf{ std::nullopt };
+    for (std::size_t number = 0; number < labelled.size(); ++number)
+    {
+        const auto &node = nodes[labelled[number]];
+        BagType type = BagType::Leaf;
+        if (node.children.size() == 2)
+        {
+            type = BagType::Join;
+        }
+        else if (node.children.size() == 1)
+        {
+            type = nodes[node.children.front()].vertices.size() < node.vertices.size() ? BagType::Intro : BagType::Forget;
+        }
+        niceBags.push_back({ type, parentOf[number], node.vertices, {} });
+        for (const auto child : node.children)
+        {
+            labelled.push_back(child);
+            parentOf.push_back(number);
+        }
+    }
+
+    // highest nice bag of every vertex, the numbering ensures parents come first
+    std::vector<std::size_t> highest(graph.vertexCount + 1, niceBags.size());
+    for (std::size_t number = niceBags.size(); number-- > 0;)
+    {
+        for (const auto v : niceBags[number].vertices)
+        {
+            highest[v] = number;
+        }
+    }
+    for (const auto &[u, v] : graph.edges)
+    {
+        const auto number = std::max(highest[u], highest[v]);
+        auto &bag = niceBags[number];
+        if (!std::binary_search(bag.vertices.cbegin(), bag.vertices.cend(), u) ||
+            !std::binary_search(bag.vertices.cbegin(), bag.vertices.cend(), v))
+        {
+            throw std::runtime_error(invalid);
+        }
+        // the vertex which appeared first comes first, as in read.py
+        if (highest[u] <= highest[v])
+        {
+            bag.introduceEdges.emplace_back(u, v);
+        }
+        else
+        {
+            bag.introduceEdges.emplace_back(v, u);
+        }
+    }
+
+    return niceBags;
+}
+
+// sum of 3^size over the bag sizes in (from, to]
+inline double introduceCost(std::size_t from, std::size_t to)
+{
+    double cost = 0;
+    for (auto size = from + 1; size <= to; ++size)
+    {
+        cost += std::pow(3.0, size);
+    }
+    return cost;
+}
+
+/**
+ * Estimated cost of the nice bags buildNiceTreeDecomposition (with joinAtUnions) creates for a TD bag with the given
+ * children, without the forgets of the children, which are counted in the transitions to this bag.
+ */
+inline double bagCost(const TreeDecomposition& td, std::size_t bag, const std::vector<std::size_t>& children)
+{
+    const auto &vertices = td.bags[bag];
+    if (children.empty())
+    {
+        // empty leaf and the introduces up to the bag
+        return 1 + introduceCost(0, vertices.size());
+    }
+    std::vector<std::vector<int>> shared;
+    shared.reserve(children.size());
+    for (const auto child : children)
+    {
+        shared.push_back(intersectionOf(td.bags[child], vertices));
+    }
+    std::stable_sort(shared.begin(), shared.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+    double cost = 0;
+    auto joined = shared.front();
+    for (auto branch = shared.cbegin() + 1; branch != shared.cend(); ++branch)
+    {
+        auto unified = unionOf(joined, *branch);
+        cost += introduceCost(joined.size(), unified.size()) + introduceCost(branch->size(), unified.size()) +
+            std::pow(3.0, unified.size()) + std::pow(4.0, unified.size());
+        joined = std::move(unified);
+    }
+    return cost + introduceCost(joined.size(), vertices.size());
+}
+
+// forgets from bag 'from' down to the vertices it shares with bag 'to', or down to the empty root if there is none
+inline double forgetCost(const TreeDecomposition& td, std::size_t from, std::optional<std::size_t> to)
+{
+    const auto shared = to.has_value() ? intersectionOf(td.bags[from], td.bags[to.value()]).size() : 0;
+    double cost = 0;
+    for (auto size = shared; size < td.bags[from].size(); ++size)
+    {
+        cost += std::pow(3.0, size);
+    }
+    return cost;
+}
+
+/**
+ * Root with the smallest estimated cost (see estimatedCost) of the nice-TD built with joinAtUnions. The cost of a
+ * rooting is a sum over the bags (given their children) and the transitions to their parents, so moving the root
+ * along an edge only changes the terms of its two ends: all roots are evaluated with one walk over the tree.
+ */
+inline std::size_t cheapestRoot(const TreeDecomposition& td, std::size_t start)
+{
+    const auto neighbors = neighborsOf(td);
+    // cost of every bag as the root, and with each of its neighbors as the parent
+    std::vector<double> rootCost(td.bags.size(), 0);
+    std::vector<std::vector<double>> childCost(td.bags.size());
+    for (std::size_t bag = 1; bag < td.bags.size(); ++bag)
+    {
+        rootCost[bag] = bagCost(td, bag, neighbors[bag]) + forgetCost(td, bag, std::nullopt);
+        for (std::size_t i = 0; i < neighbors[bag].size(); ++i)
+        {
+            auto children = neighbors[bag];
+            children.erase(children.begin() + i);
+            childCost[bag].push_back(bagCost(td, bag, children) + forgetCost(td, bag, neighbors[bag][i]));
+        }
+    }
+
+    std::vector<double> cost(td.bags.size(), 0);
+    std::vector<std::optional<std::size_t>> parent(td.bags.size());
+    std::vector<std::size_t> order{ start };
+    std::vector<bool> visited(td.bags.size(), false);
+    visited[start] = true;
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const auto bag = order[i];
+        for (std::size_t j = 0; j < neighbors[bag].size(); ++j)
+        {
+            const auto neighbor = neighbors[bag][j];
+            if (!visited[neighbor])
+            {
+                visited[neighbor] = true;
+                parent[neighbor] = bag;
+                order.push_back(neighbor);
+            }
+        }
+    }
+    const auto indexOf = [&neighbors](std::size_t bag, std::size_t neighbor)
+    {
+        return static_cast<std::size_t>(std::find(neighbors[bag].cbegin(), neighbors[bag].cend(), neighbor) -
+            neighbors[bag].cbegin());
+    };
+    // cost of the rooting at 'start', then move the root from every parent to its children
+    cost[start] = rootCost[start];
+    for (auto it = order.cbegin() + 1; it != order.cend(); ++it)
+    {
+        cost[start] += childCost[*it][indexOf(*it, parent[*it].value())];
+    }
+    for (auto it = order.cbegin() + 1; it != order.cend(); ++it)
+    {
+        const auto bag = *it;
+        const auto above = parent[bag].value();
+        cost[bag] = cost[above] - rootCost[above] - childCost[bag][indexOf(bag, above)] +
+            childCost[above][indexOf(above, bag)] + rootCost[bag];
+    }
+    return *std::min_element(order.cbegin(), order.cend(), [&cost](std::size_t a, std::size_t b)
+    {
+        return cost[a] < cost[b];
+    });
+}
+
+} // namespace detail
+
+/**
+ * Checks that 'td' is a valid tree-decomposition of 'graph' (like sage's is_valid_tree_decomposition) and builds a
+ * labelled nice-TD from it (like make_nice_tree_decomposition and label_nice_tree_decomposition): the root is an empty
+ * forget bag, leaves are empty, introduce and forget bags differ from their child by one vertex and join bags equal
+ * both children. Bags are numbered in BFS order from the root, the TD is rooted at its first non-empty bag.
+ * Every edge is introduced in the highest bag containing both endpoints, which is where the second of its endpoints
+ * appears first when walking down from the root (the assignment loop in read.py).
+ */
+inline std::vector<NiceBag> makeNiceTreeDecomposition(const Graph& graph, const TreeDecomposition& td)
+{
+    std::size_t root = 1;
+    while (root + 1 < td.bags.size() && td.bags[root].empty())
+    {
+        root++;
+    }
+    return detail::buildNiceTreeDecomposition(graph, td, detail::rootTreeDecomposition(graph, td, root), false);
+}
+
+/**
+ * Estimated work of the DP on a nice-TD: every bag fills a table of 3^size entries, join bags additionally walk the
+ * 4^size consistent triples.
+ */
+inline double estimatedCost(const std::vector<NiceBag>& niceBags)
+{
+    double cost = 0;
+    for (const auto &bag : niceBags)
+    {
+        cost += std::pow(3.0, bag.vertices.size()) + (bag.type == BagType::Join ? std::pow(4.0, bag.vertices.size()) : 0);
+    }
+    return cost;
+}
+
+/**
+ * Contracts every bag which is a subset of a neighboring bag into that neighbor, the result is again a TD of the same
+ * graph with at most the same width. Expects a valid TD.
+ */
+inline TreeDecomposition mergeRedundantBags(const TreeDecomposition& td)
+{
+    // union-find over the bags, the representative of a group holds the (largest) bag of the whole group
+    std::vector<std::size_t> group(td.bags.size());
+    std::iota(group.begin(), group.end(), 0);
+    const std::function<std::size_t(std::size_t)> find = [&group, &find](std::size_t bag) -> std::size_t
+    {
+        return group[bag] == bag ? bag : group[bag] = find(group[bag]);
+    };
+    const auto subset = [&td](std::size_t a, std::size_t b)
+    {
+        return std::includes(td.bags[b].cbegin(), td.bags[b].cend(), td.bags[a].cbegin(), td.bags[a].cend());
+    };
+    // groups only grow, so an edge may become contractible after others were contracted
+    for (auto merged = true; merged;)
+    {
+        merged = false;
+        for (const auto &[a, b] : td.edges)
+        {
+            const auto groupA = find(a);
+            const auto groupB = find(b);
+            if (groupA != groupB && (subset(groupA, groupB) || subset(groupB, groupA)))
+            {
+                const auto smaller = subset(groupA, groupB) ? groupA : groupB;
+                group[smaller] = smaller == groupA ? groupB : groupA;
+                merged = true;
+            }
+        }
+    }
+
+    TreeDecomposition result;
+    std::vector<std::size_t> number(td.bags.size(), 0);
+    result.bags.emplace_back();
+    for (std::size_t bag = 1; bag < td.bags.size(); ++bag)
+    {
+        if (find(bag) == bag)
+        {
+            number[bag] = result.bags.size();
+            result.bags.push_back(td.bags[bag]);
+        }
+    }
+    for (const auto &[a, b] : td.edges)
+    {
+        if (find(a) != find(b))
+        {
+            result.edges.emplace_back(number[find(a)], number[find(b)]);
+        }
+    }
+    return result;
+}
+
+/**
+ * makeNiceTreeDecomposition with a preprocessing of the TD that makes the DP cheaper (by estimatedCost): redundant bags
+ * are merged, the TD is rooted at the bag that minimizes the estimated cost and the children of a bag are joined on the
+ * vertices they share with it, so joins are as narrow as possible and vertices are forgotten right above their last
+ * bag.
+ */
+inline std::vector<NiceBag> makeOptimizedNiceTreeDecomposition(const Graph& graph, const TreeDecomposition& td)
+{
+    // check the input first, merging could hide a broken TD
+    detail::rootTreeDecomposition(graph, td, 1);
+    const auto merged = mergeRedundantBags(td);
+    const auto root = detail::cheapestRoot(merged, 1);
+    return detail::buildNiceTreeDecomposition(graph, merged, detail::rootTreeDecomposition(graph, merged, root), true);
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * Processes the nodes of a rooted binary tree bottom-up on a pool of threads with work-stealing.
+ * A node is processed as soon as all of its children are, the two subtrees below a node with two children are
+ * independent and can be processed by different threads.
+ *
+ * A task is a whole subtree: a worker descends from its root along the first children and pushes every second child
+ * onto its own deque. At a leaf it walks upwards, processing nodes until it reaches a node whose other child is not
+ * finished yet; whoever finishes the last child of a node continues with that node. Owners pop the newest task
+ * (depth-first, so a single thread processes the tree in postorder), idle workers steal the oldest (largest) ones.
+ */
+class TreeScheduler
+{
+public:
+    struct Node
+    {
+        std::optional<std::size_t> parent;
+        std::optional<std::size_t> child1;
+        std::optional<std::size_t> child2;
+    };
+
+    TreeScheduler(const std::vector<Node>& nodes, std::size_t threadCount) :
+        threadCount(std::max<std::size_t>(threadCount, 1)), pendingChildren(nodes.size()), deques(this->threadCount)
+    {
+        assert(nodes.size() < none);
+        const auto numberOf = [](const std::optional<std::size_t>& node)
+        {
+            return node.has_value() ? static_cast<std::uint32_t>(node.value()) : none;
+        };
+        parents.reserve(nodes.size());
+        firstChildren.reserve(nodes.size());
+        secondChildren.reserve(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            parents.push_back(numberOf(nodes[i].parent));
+            firstChildren.push_back(numberOf(nodes[i].child1));
+            secondChildren.push_back(numberOf(nodes[i].child2));
+            pendingChildren[i].store(nodes[i].child1.has_value() + nodes[i].child2.has_value());
+        }
+    }
+
+    /**
+     * Calls 'process' for every node of the tree below 'root' after it was called for all children of the node.
+     * The worker index (< threadCount) is passed along, e.g. for per-thread scratch memory. The first exception of
+     * 'process' stops all workers (nodes that already run are finished), it is rethrown once they are joined.
+     */
+    void run(std::size_t root, const std::function<void(std::size_t node, std::size_t worker)>& process)
+    {
+        assert(parents[root] == none);
+        this->root = root;
+        this->process = &process;
+        push(0, root);
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (std::size_t worker = 1; worker < threadCount; ++worker)
+        {
+            threads.emplace_back([this, worker]() { work(worker); });
+        }
+        work(0);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        if (error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // number of workers currently waiting for a task, these can help with the work inside of a node (see helpWith)
+    std::size_t idleWorkers() const
+    {
+        return sleeping.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Called by 'process': runs 'work' on the calling worker and on up to 'helpers' workers that are idle meanwhile,
+     * which then take no subtree until they return from 'work'. Returns once all of them have, the first exception of
+     * a helper is rethrown. 'work' has to hand out its parts itself, a helper may join late or not at all.
+     */
+    void helpWith(std::size_t helpers, const std::function<void()>& work)
+    {
+        HelpRequest request{ &work, helpers, 0, nullptr };
+        if (helpers > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                requests.push_back(&request);
+            }
+            idle.notify_all();
+        }
+        std::exception_ptr ownError;
+        try
+        {
+            work();
+        }
+        catch (...)
+        {
+            ownError = std::current_exception();
+        }
+        if (helpers > 0)
+        {
+            std::unique_lock<std::mutex> lock(idleMutex);
+            // no more helpers join once the caller is done
+            const auto it = std::find(requests.begin(), requests.end(), &request);
+            if (it != requests.end())
+            {
+                requests.erase(it);
+            }
+            helped.wait(lock, [&request]() { return request.running == 0; });
+        }
+        if (ownError != nullptr || request.error != nullptr)
+        {
+            std::rethrow_exception(ownError != nullptr ? ownError : request.error);
+        }
+    }
+
+private:
+    struct WorkerDeque
+    {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    // work inside of a node that idle workers may join, guarded by idleMutex
+    struct HelpRequest
+    {
+        const std::function<void()>* work;
+        // helpers that may still join
+        std::size_t slots;
+        std::size_t running = 0;
+        std::exception_ptr error;
+    };
+
+    void push(std::size_t worker, std::size_t subtreeRoot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(deques[worker].mutex);
+            deques[worker].tasks.push_back(subtreeRoot);
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            queued++;
+        }
+        idle.notify_one();
+    }
+
+    std::optional<std::size_t> pop(std::size_t worker)
+    {
+        // own deque from the back, then steal from the front of the other ones
+        for (std::size_t i = 0; i < threadCount; ++i)
+        {
+            auto &deque = deques[(worker + i) % threadCount];
+            std::lock_guard<std::mutex> lock(deque.mutex);
+            if (!deque.tasks.empty())
+            {
+                std::size_t task;
+                if (i == 0)
+                {
+                    task = deque.tasks.back();
+                    deque.tasks.pop_back();
+                }
+                else
+                {
+                    task = deque.tasks.front();
+                    deque.tasks.pop_front();
+                }
+                std::lock_guard<std::mutex> idleLock(idleMutex);
+                queued--;
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void work(std::size_t worker)
+    {
+        while (!aborted.load(std::memory_order_relaxed))
+        {
+            auto task = pop(worker);
+            if (!task.has_value())
+            {
+                std::unique_lock<std::mutex> lock(idleMutex);
+                sleeping++;
+                idle.wait(lock, [this]() { return queued > 0 || finished || !requests.empty(); });
+                sleeping--;
+                if (finished)
+                {
+                    return;
+                }
+                if (queued == 0)
+                {
+                    help(lock);
+                }
+                continue;
+            }
+            try
+            {
+                runSubtree(worker, task.value());
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    error = error != nullptr ? error : std::current_exception();
+                    finished = true;
+                }
+                aborted.store(true, std::memory_order_relaxed);
+                idle.notify_all();
+                return;
+            }
+        }
+    }
+
+    // joins the oldest help request, 'lock' holds idleMutex
+    void help(std::unique_lock<std::mutex>& lock)
+    {
+        auto &request = *requests.front();
+        if (--request.slots == 0)
+        {
+            requests.pop_front();
+        }
+        request.running++;
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            (*request.work)();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        request.error = request.error != nullptr ? request.error : error;
+        if (--request.running == 0)
+        {
+            helped.notify_all();
+        }
+    }
+
+    void runSubtree(std::size_t worker, std::size_t node)
+    {
+        // descend to a leaf, second children are left for later or for other workers
+        while (firstChildren[node] != none)
+        {
+            if (secondChildren[node] != none)
+            {
+                push(worker, secondChildren[node]);
+            }
+            node = firstChildren[node];
+        }
+
+        // walk upwards as long as this worker finished the last missing child
+        while (!aborted.load(std::memory_order_relaxed))
+        {
+            (*process)(node, worker);
+            if (node == root)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    finished = true;
+                }
+                idle.notify_all();
+                return;
+            }
+            node = parents[node];
+            if (pendingChildren[node].fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+        }
+    }
+
+    // the tree as one array per field (none marks a missing node), 32-bit numbers keep the descent in few cache lines
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> parents;
+    std::vector<std::uint32_t> firstChildren;
+    std::vector<std::uint32_t> secondChildren;
+    const std::size_t threadCount;
+    std::vector<std::atomic<std::uint8_t>> pendingChildren;
+    std::vector<WorkerDeque> deques;
+    std::size_t root = 0;
+    const std::function<void(std::size_t, std::size_t)>* process = nullptr;
+
+    std::mutex idleMutex;
+    std::condition_variable idle;
+    std::size_t queued = 0;
+    bool finished = false;
+    std::atomic<std::size_t> sleeping = 0;
+    std::deque<HelpRequest*> requests;
+    std::condition_variable helped;
+    // set with the first exception of 'process', the workers then stop taking nodes
+    std::exception_ptr error;
+    std::atomic<bool> aborted = false;
+};